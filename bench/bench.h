@@ -0,0 +1,20 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+
+// runs func once and prints the elapsed time in milliseconds
+template <typename Func>
+double measure(const char* name, Func&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto finish = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(finish - start).count();
+    std::printf("%-40s %10.2f ms\n", name, ms);
+    return ms;
+}
+
+// keeps the compiler from optimizing away the computed value
+template <typename T>
+void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+
+#include "bench.h"
+#include "bit_deque.h"
+#include "deque.h"
+
+// heap bytes taken by all the containers that use counting_allocator
+static std::size_t allocated_bytes = 0;
+
+template <typename T>
+struct counting_allocator {
+    using value_type = T;
+
+    counting_allocator() = default;
+    template <typename U>
+    counting_allocator(const counting_allocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        allocated_bytes += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* ptr, std::size_t n) {
+        allocated_bytes -= n * sizeof(T);
+        std::allocator<T>().deallocate(ptr, n);
+    }
+
+    friend bool operator==(const counting_allocator&, const counting_allocator&) { return true; }
+};
+
+// compares bit_deque with deque<bool> on 100M flags, 1 in 1000 of them set: memory, push_back, counting the set
+// flags, visiting the set flags and setting a range
+int main() {
+    constexpr std::size_t n = 100'000'000;
+    std::mt19937 gen(42);
+    std::bernoulli_distribution sparse(0.001);
+
+    deque<bool, counting_allocator<bool>> flags;
+    bit_deque<counting_allocator<std::uint64_t>> bits;
+
+    std::printf("push_back, %zu flags\n", n);
+    measure("  deque<bool>", [&]() {
+        flags.clear();
+        std::mt19937 g = gen;
+        for (std::size_t i = 0; i < n; ++i) {
+            flags.push_back(sparse(g));
+        }
+    });
+    std::size_t flags_bytes = allocated_bytes;
+    measure("  bit_deque", [&]() {
+        bits.clear();
+        std::mt19937 g = gen;
+        for (std::size_t i = 0; i < n; ++i) {
+            bits.push_back(sparse(g));
+        }
+    });
+    std::size_t bits_bytes = allocated_bytes - flags_bytes;
+    std::printf("bytes per flag\n  deque<bool>: %.3f\n  bit_deque: %.3f\n", double(flags_bytes) / n,
+                double(bits_bytes) / n);
+
+    std::size_t cnt = 0;
+    std::printf("count set flags\n");
+    measure("  std::count on deque<bool>", [&]() { cnt = std::count(flags.begin(), flags.end(), true); });
+    do_not_optimize(cnt);
+    measure("  bit_deque::count", [&]() { cnt = bits.count(); });
+    do_not_optimize(cnt);
+
+    std::size_t sum = 0;
+    std::printf("visit set flags\n");
+    measure("  loop on deque<bool>", [&]() {
+        sum = 0;
+        for (std::size_t i = 0; i < flags.size(); ++i) {
+            if (flags[i]) {
+                sum += i;
+            }
+        }
+    });
+    do_not_optimize(sum);
+    measure("  bit_deque::find_next", [&]() {
+        sum = 0;
+        for (std::size_t i = bits.find_first(); i != bits.npos; i = bits.find_next(i)) {
+            sum += i;
+        }
+    });
+    do_not_optimize(sum);
+
+    std::printf("set flags [n / 4, 3n / 4)\n");
+    measure("  std::fill on deque<bool>", [&]() { std::fill(flags.begin() + n / 4, flags.begin() + 3 * n / 4, true); });
+    measure("  bit_deque::set_range", [&]() { bits.set_range(n / 4, 3 * n / 4); });
+    do_not_optimize(flags.size() + bits.size());
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "bench.h"
+#include "deque.h"
+
+// runs func on a copy of input once to warm up the allocator, then measures it on another copy
+template <typename T, typename Func>
+void measure_on_copy(const char* name, const deque<T>& input, Func func) {
+    {
+        deque<T> d = input;
+        func(d);
+    }
+    deque<T> d = input;
+    measure(name, [&]() { func(d); });
+    do_not_optimize(d.size());
+}
+
+// filters and deduplicates a deque with the block-wise compaction (erase_if, unique) and with the generic algorithms
+// over iterators followed by erase
+template <typename T, typename Make>
+void run(const char* title, int n, Make make) {
+    std::printf("%s, %d elements\n", title, n);
+    std::mt19937 rng(42);
+    deque<T> source;
+    for (int i = 0; i < n; ++i) {
+        source.push_back(make(static_cast<int>(rng() % 1000)));
+    }
+    auto odd = [](const T& value) { return value % 2 != 0; };
+    measure_on_copy("  erase_if", source, [&](deque<T>& d) { erase_if(d, odd); });
+    measure_on_copy("  std::remove_if + erase", source,
+                    [&](deque<T>& d) { d.erase(std::remove_if(d.begin(), d.end(), odd), d.end()); });
+
+    // runs of 4 equal elements on average
+    deque<T> runs;
+    for (int i = 0; i < n; ++i) {
+        runs.push_back(make(i / 4 + static_cast<int>(rng() % 2)));
+    }
+    measure_on_copy("  unique", runs, [](deque<T>& d) { d.unique(); });
+    measure_on_copy("  std::unique + erase", runs,
+                    [](deque<T>& d) { d.erase(std::unique(d.begin(), d.end()), d.end()); });
+}
+
+struct padded_string {
+    std::string value;
+    bool operator==(const padded_string& other) const = default;
+    int operator%(int mod) const { return static_cast<int>(value.size()) % mod; }
+};
+
+int main() {
+    run<int>("int", 10'000'000, [](int v) { return v; });
+    run<padded_string>("std::string", 1'000'000,
+                       [](int v) { return padded_string{std::string(20 + v % 20, static_cast<char>('a' + v % 26))}; });
+    return 0;
+}
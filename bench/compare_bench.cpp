@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <compare>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <unordered_set>
+
+#include "bench.h"
+#include "deque.h"
+
+// compares and hashes deques block by block (==, <=>, std::hash) and element by element through operator[] and the
+// iterators; the two deques have different block offsets, so their blocks don't line up
+template <typename T, typename Make>
+void run(const char* title, int n, Make make) {
+    std::printf("%s, %d elements\n", title, n);
+    deque<T> a;
+    deque<T> b;
+    for (int i = 0; i < n; ++i) {
+        a.push_back(make(i));
+    }
+    for (int i = n; i-- > 0;) {
+        b.push_front(make(i));
+    }
+    bool equal = false;
+    measure("  operator==", [&]() { equal = a == b; });
+    do_not_optimize(equal);
+    measure("  operator[] loop", [&]() {
+        equal = true;
+        for (std::size_t i = 0; i < a.size() && equal; ++i) {
+            equal = a[i] == b[i];
+        }
+    });
+    do_not_optimize(equal);
+
+    std::weak_ordering order = std::weak_ordering::equivalent;
+    measure("  operator<=>", [&]() { order = a <=> b; });
+    do_not_optimize(order);
+    measure("  lexicographical_compare_three_way", [&]() {
+        order = std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end());
+    });
+    do_not_optimize(order);
+
+    std::size_t hash = 0;
+    measure("  std::hash", [&]() { hash = std::hash<deque<T>>{}(a); });
+    do_not_optimize(hash);
+    measure("  std::hash per element", [&]() {
+        hash = 0;
+        for (const T& value : a) {
+            hash = hash * 31 + std::hash<T>{}(value);
+        }
+    });
+    do_not_optimize(hash);
+}
+
+int main() {
+    run<int>("int", 10'000'000, [](int i) { return i; });
+    run<std::string>("std::string", 1'000'000, [](int i) { return std::to_string(i); });
+
+    // deduplication of 1M deque keys of 64 elements with 1000 distinct values
+    std::printf("unordered_set<deque<int>>, 1M keys\n");
+    std::unordered_set<deque<int>> keys;
+    measure("  insert", [&]() {
+        for (int i = 0; i < 1'000'000; ++i) {
+            deque<int> key;
+            for (int j = 0; j < 64; ++j) {
+                key.push_back(i % 1000 + j);
+            }
+            keys.insert(std::move(key));
+        }
+    });
+    do_not_optimize(keys.size());
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+#include "compressed_deque.h"
+#include "deque.h"
+
+void run(const char* name, const std::vector<std::int64_t>& values) {
+    std::printf("%s, %zu elements\n", name, values.size());
+
+    deque<std::int64_t> plain(values.begin(), values.end());
+    compressed_deque<std::int64_t> compressed;
+    for (std::int64_t value : values) {
+        compressed.push_back(value);
+    }
+    std::printf("  compressed_deque bytes per element %10.3f\n",
+                static_cast<double>(compressed.memory_bytes()) / compressed.size());
+
+    std::int64_t sum = 0;
+    measure("  deque scan", [&]() { sum = std::accumulate(plain.begin(), plain.end(), std::int64_t(0)); });
+    do_not_optimize(sum);
+
+    sum = 0;
+    measure("  compressed_deque scan", [&]() {
+        compressed.for_each_block([&sum](std::span<const std::int64_t> block) {
+            sum = std::accumulate(block.begin(), block.end(), sum);
+        });
+    });
+    do_not_optimize(sum);
+
+    std::mt19937 rng(7);
+    measure("  compressed_deque random access x1M", [&]() {
+        for (int i = 0; i < 1000000; ++i) {
+            sum += compressed[rng() % compressed.size()];
+        }
+    });
+    do_not_optimize(sum);
+}
+
+int main() {
+    const std::size_t n = 1 << 23;
+    std::mt19937_64 rng(42);
+    std::vector<std::int64_t> values(n);
+
+    // nanosecond timestamps of events about a millisecond apart
+    std::int64_t ts = 1700000000000000000;
+    for (auto& value : values) {
+        value = ts += 1000000 + static_cast<std::int64_t>(rng() % 1000);
+    }
+    run("timestamps", values);
+
+    // prices in ticks moving by a few ticks at a time
+    std::int64_t price = 1000000;
+    for (auto& value : values) {
+        value = price += static_cast<std::int64_t>(rng() % 21) - 10;
+    }
+    run("random walk", values);
+
+    // quantities
+    for (auto& value : values) {
+        value = static_cast<std::int64_t>(rng() % 256);
+    }
+    run("small integers", values);
+
+    for (auto& value : values) {
+        value = static_cast<std::int64_t>(rng());
+    }
+    run("random 64-bit", values);
+
+    return 0;
+}
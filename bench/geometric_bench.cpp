@@ -0,0 +1,57 @@
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+#include "deque.h"
+#include "geometric_deque.h"
+
+// fills a deque by push_back, then scans it and reads it at random positions
+template <typename Deque>
+void run(const char* name, std::size_t n, const std::vector<std::size_t>& positions) {
+    std::printf("%s, %zu elements\n", name, n);
+    Deque d;
+    measure("  push_back", [&]() {
+        for (std::size_t i = 0; i < n; ++i) {
+            d.push_back(static_cast<int>(i));
+        }
+    });
+
+    std::int64_t sum = 0;
+    measure("  scan", [&]() { sum = std::accumulate(d.begin(), d.end(), std::int64_t(0)); });
+    do_not_optimize(sum);
+
+    measure("  random access", [&]() {
+        for (std::size_t pos : positions) {
+            sum += d[pos];
+        }
+    });
+    do_not_optimize(sum);
+
+    measure("  queue of n / 2 elements, n pushes", [&]() {
+        for (std::size_t i = 0; i < n / 2; ++i) {
+            d.pop_front();
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            d.push_back(static_cast<int>(i));
+            d.pop_front();
+        }
+    });
+}
+
+int main() {
+    const std::size_t n = 1 << 27;
+    std::mt19937_64 rng(42);
+    std::vector<std::size_t> positions(1 << 22);
+    for (auto& pos : positions) {
+        pos = rng() % n;
+    }
+
+    // the map of deque<int> has n / 128 pointers here, geometric_deque has at most 2 * 64
+    run<deque<int>>("deque", n, positions);
+    run<geometric_deque<int>>("geometric_deque", n, positions);
+
+    return 0;
+}
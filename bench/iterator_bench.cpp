@@ -0,0 +1,35 @@
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+#include "deque.h"
+
+template <typename Deque>
+void run(const char* sort_name, const char* search_name, const std::vector<int>& values) {
+    Deque d(values.begin(), values.end());
+    measure(sort_name, [&d]() { std::sort(d.begin(), d.end()); });
+
+    long long found = 0;
+    measure(search_name, [&]() {
+        for (int value : values) {
+            found += std::lower_bound(d.begin(), d.end(), value) - d.begin();
+        }
+    });
+    do_not_optimize(found);
+}
+
+int main() {
+    const std::size_t n = 1 << 22;
+    std::mt19937 rng(42);
+    std::vector<int> values(n);
+    for (auto& value : values) {
+        value = static_cast<int>(rng());
+    }
+
+    run<std::deque<int>>("std::deque std::sort", "std::deque std::lower_bound", values);
+    run<deque<int>>("deque std::sort", "deque std::lower_bound", values);
+
+    return 0;
+}
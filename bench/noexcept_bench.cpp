@@ -0,0 +1,104 @@
+#include <cstdio>
+
+#include "bench.h"
+#include "deque.h"
+
+// an int whose constructors and assignments may throw as far as the compiler knows, so the deque keeps its
+// rollback paths for it
+struct throwing_int {
+    int value;
+
+    throwing_int(int v) noexcept(false) : value(v) {}
+    throwing_int(const throwing_int& other) noexcept(false) : value(other.value) {}
+    throwing_int(throwing_int&& other) noexcept(false) : value(other.value) {}
+    throwing_int& operator=(const throwing_int& other) noexcept(false) {
+        value = other.value;
+        return *this;
+    }
+    throwing_int& operator=(throwing_int&& other) noexcept(false) {
+        value = other.value;
+        return *this;
+    }
+    operator int() const { return value; }
+};
+
+template <typename T>
+void run(const char* name) {
+    const int n = 1 << 24;
+    const int k = 2000;
+    std::printf("%s\n", name);
+
+    deque<T> d;
+    measure("  push_back", [&]() {
+        for (int i = 0; i < n; ++i) {
+            d.push_back(T(i));
+        }
+    });
+    measure("  push_front", [&]() {
+        for (int i = 0; i < n; ++i) {
+            d.push_front(T(i));
+        }
+    });
+    long long sum = 0;
+    measure("  pop_back, pop_front", [&]() {
+        for (int i = 0; i < n; ++i) {
+            sum += d.back();
+            d.pop_back();
+            sum += d.front();
+            d.pop_front();
+        }
+    });
+    do_not_optimize(sum);
+
+    deque<T> q;
+    for (int i = 0; i < 1000; ++i) {
+        q.push_back(T(i));
+    }
+    measure("  push_back, pop_front on 1K elements", [&]() {
+        for (int i = 0; i < n * 4; ++i) {
+            q.push_back(T(i));
+            sum += q.front();
+            q.pop_front();
+        }
+    });
+    do_not_optimize(sum);
+
+    deque<T> m;
+    for (int i = 0; i < (1 << 16); ++i) {
+        m.push_back(T(i));
+    }
+    measure("  insert, erase in the middle of 64K", [&]() {
+        for (int i = 0; i < k; ++i) {
+            m.insert(m.begin() + m.size() / 3, T(i));
+            m.erase(m.begin() + m.size() / 3 * 2);
+        }
+    });
+
+    for (int i = 0; i < n; ++i) {
+        d.push_back(T(i));
+    }
+    for (int i = 0; i < n / 2; ++i) {
+        d.pop_back();
+    }
+    measure("  shrink_to_fit", [&]() { d.shrink_to_fit(); });
+    sum = 0;
+    for (const auto& value : d) {
+        sum += value;
+    }
+    do_not_optimize(sum);
+}
+
+int main() {
+    {
+        // the first run would also pay for faulting in fresh memory
+        deque<int> warm_up;
+        for (int i = 0; i < (1 << 25); ++i) {
+            warm_up.push_back(i);
+            warm_up.push_front(i);
+        }
+        do_not_optimize(warm_up.back());
+    }
+    run<int>("int");
+    run<throwing_int>("throwing_int");
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+#include "deque.h"
+
+// hands out the element blocks from random places of one big arena, the way the blocks of a long-lived deque end up
+// spread over the heap; everything else (the map) comes from std::allocator
+struct scattered_arena {
+    std::size_t block_bytes = 0;
+    std::unique_ptr<char[]> memory;
+    std::vector<char*> free_blocks;
+
+    scattered_arena(std::size_t blocks_cnt, std::size_t bytes) : block_bytes(bytes), memory(new char[blocks_cnt * bytes]) {
+        for (std::size_t i = 0; i < blocks_cnt; ++i) {
+            free_blocks.push_back(memory.get() + i * bytes);
+        }
+        std::shuffle(free_blocks.begin(), free_blocks.end(), std::mt19937(42));
+    }
+};
+
+static scattered_arena* arena = nullptr;
+
+template <typename T>
+struct scattered_allocator {
+    using value_type = T;
+
+    scattered_allocator() = default;
+    template <typename U>
+    scattered_allocator(const scattered_allocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        if (n * sizeof(T) == arena->block_bytes && !arena->free_blocks.empty()) {
+            T* block = reinterpret_cast<T*>(arena->free_blocks.back());
+            arena->free_blocks.pop_back();
+            return block;
+        }
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        char* block = reinterpret_cast<char*>(p);
+        if (block >= arena->memory.get() && block < arena->memory.get() + arena->block_bytes * (std::size_t(1) << 20)) {
+            arena->free_blocks.push_back(block);
+            return;
+        }
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const scattered_allocator<U>&) const {
+        return true;
+    }
+};
+
+// scans of a deque much larger than the last-level cache; prefetch_bench_off is the same program built with
+// DEQUE_PREFETCH_DISTANCE=0 and prefetch_bench_iterators with DEQUE_PREFETCH_ITERATORS=1
+int main() {
+    const std::size_t n = std::size_t(1) << 26;  // 512 MB of elements
+    std::printf("prefetch distance %zu, iterators %s\n", deque_prefetch_distance,
+                deque_prefetch_iterators ? "on" : "off");
+
+    const std::size_t block_bytes = deque_buffer_size;
+    scattered_arena scattered(std::size_t(1) << 20, block_bytes);
+    arena = &scattered;
+
+    deque<std::uint64_t, scattered_allocator<std::uint64_t>> d;
+    for (std::size_t i = 0; i < n; ++i) {
+        d.push_back(i);
+    }
+
+    std::uint64_t sum = 0;
+    measure("forward scan", [&]() {
+        for (auto value : d) {
+            sum += value;
+        }
+    });
+    do_not_optimize(sum);
+
+    sum = 0;
+    measure("reverse scan", [&]() {
+        for (auto it = d.rbegin(); it != d.rend(); ++it) {
+            sum += *it;
+        }
+    });
+    do_not_optimize(sum);
+
+    measure("std::accumulate", [&]() { sum = std::accumulate(d.begin(), d.end(), std::uint64_t(0)); });
+    do_not_optimize(sum);
+
+    measure("assign (node-wise)", [&]() { d.assign(n, 1); });
+    do_not_optimize(d.back());
+
+    measure("copy (node-wise)", [&]() {
+        auto copy = d;
+        do_not_optimize(copy.back());
+    });
+
+    return 0;
+}
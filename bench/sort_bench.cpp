@@ -0,0 +1,51 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "deque.h"
+
+// measures func on a copy of input after running it once on another copy, so that the allocator is warm
+template <typename T, typename Func>
+void measure_on_copy(const char* name, const deque<T>& input, Func func) {
+    {
+        deque<T> d = input;
+        func(d);
+    }
+    deque<T> d = input;
+    measure(name, [&]() { func(d); });
+    do_not_optimize(d.front());
+}
+
+// deque::sort and stable_sort against std::sort and std::stable_sort over the deque iterators and over a vector
+template <typename T, typename Make>
+void run(const char* title, int n, Make make) {
+    std::printf("%s, %d elements\n", title, n);
+    std::mt19937 rng(42);
+    deque<T> input;
+    for (int i = 0; i < n; ++i) {
+        input.push_back(make(rng()));
+    }
+    // a comparator other than std::less, which would take the radix sort for integers
+    auto less = [](const T& a, const T& b) { return a < b; };
+
+    measure_on_copy("  sort", input, [](deque<T>& d) { d.sort(); });
+    measure_on_copy("  sort(comp)", input, [&](deque<T>& d) { d.sort(less); });
+    measure_on_copy("  sort(deque_sort_threads{}, comp)", input, [&](deque<T>& d) { d.sort(deque_sort_threads{}, less); });
+    measure_on_copy("  std::sort", input, [](deque<T>& d) { std::sort(d.begin(), d.end()); });
+    measure_on_copy("  stable_sort(comp)", input, [&](deque<T>& d) { d.stable_sort(less); });
+    measure_on_copy("  std::stable_sort", input, [](deque<T>& d) { std::stable_sort(d.begin(), d.end()); });
+    std::vector<T> v(input.begin(), input.end());
+    measure("  std::sort on a vector", [&]() { std::sort(v.begin(), v.end()); });
+    do_not_optimize(v.front());
+}
+
+int main() {
+    run<int>("int", 10'000'000, [](unsigned x) { return static_cast<int>(x); });
+    run<std::uint64_t>("uint64_t", 5'000'000, [](unsigned x) { return std::uint64_t(x) * 0x9E3779B97F4A7C15; });
+    run<std::string>("std::string", 1'000'000, [](unsigned x) { return std::to_string(x); });
+    return 0;
+}
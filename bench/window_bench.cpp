@@ -0,0 +1,61 @@
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "deque.h"
+#include "sliding_window.h"
+
+// every tick pushes a price, drops the oldest one and reads min, max and sum of the window
+void run(std::size_t window, std::size_t ticks, const std::vector<double>& prices) {
+    std::printf("window %zu, %zu ticks\n", window, ticks);
+
+    deque<double> full(prices.begin(), prices.begin() + window);
+    double checksum = 0;
+    measure("  full recomputation", [&]() {
+        for (std::size_t i = window; i < window + ticks; ++i) {
+            full.push_back(prices[i]);
+            full.pop_front();
+            auto [min_it, max_it] = std::minmax_element(full.begin(), full.end());
+            checksum += *min_it + *max_it + std::accumulate(full.begin(), full.end(), 0.0);
+        }
+    });
+    do_not_optimize(checksum);
+
+    sliding_window<double> sliding;
+    for (std::size_t i = 0; i < window; ++i) {
+        sliding.push_back(prices[i]);
+    }
+    checksum = 0;
+    measure("  sliding_window", [&]() {
+        for (std::size_t i = window; i < window + ticks; ++i) {
+            sliding.push_back(prices[i]);
+            sliding.pop_front();
+            checksum += sliding.min() + sliding.max() + sliding.aggregate();
+        }
+    });
+    do_not_optimize(checksum);
+}
+
+int main() {
+    const std::size_t ticks = 2000;
+    const std::size_t max_window = 1000000;
+
+    std::mt19937 rng(42);
+    std::normal_distribution<double> step(0.0, 1.0);
+    std::vector<double> prices(max_window + ticks);
+    double price = 1000;
+    for (auto& value : prices) {
+        price += step(rng);
+        value = price;
+    }
+
+    for (std::size_t window : {100, 1000, 10000, 100000, 1000000}) {
+        run(window, ticks, prices);
+    }
+
+    return 0;
+}
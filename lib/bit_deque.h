@@ -0,0 +1,198 @@
+#pragma once
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "deque.h"
+
+// deque of flags packed 64 to a word: the words are kept in a deque<std::uint64_t>, so a default block of
+// deque_buffer_size bytes holds 4096 flags instead of 512 in deque<bool>. The first flag may start anywhere in the
+// first word, which makes push and pop at both ends O(1). Bits of the words outside the flags are always 0, so
+// count, find_first and find_next look at whole words without masking them
+template <typename Allocator = std::allocator<std::uint64_t>>
+class bit_deque {
+   public:
+    class reference;
+
+    template <bool Const>
+    class Iterator;
+
+    using value_type = bool;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using const_reference = bool;
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // returned by find_first and find_next when there is no set flag
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    bit_deque() = default;
+    explicit bit_deque(const Allocator& alloc);
+    explicit bit_deque(size_type count, bool value = false, const Allocator& alloc = Allocator());
+    bit_deque(std::initializer_list<bool> init, const Allocator& alloc = Allocator());
+
+    template <typename InputIt>
+    bit_deque(InputIt first, InputIt last, const Allocator& alloc = Allocator());
+
+    allocator_type get_allocator() const;
+
+    reference at(size_type pos);
+    const_reference at(size_type pos) const;
+
+    reference operator[](size_type pos);
+    const_reference operator[](size_type pos) const;
+
+    reference front();
+    const_reference front() const;
+
+    reference back();
+    const_reference back() const;
+
+    iterator begin();
+    const_iterator begin() const;
+    const_iterator cbegin() const noexcept;
+
+    iterator end();
+    const_iterator end() const;
+    const_iterator cend() const noexcept;
+
+    reverse_iterator rbegin();
+    const_reverse_iterator rbegin() const;
+
+    reverse_iterator rend();
+    const_reverse_iterator rend() const;
+
+    [[nodiscard]] bool empty() const;
+    size_type size() const;
+
+    void clear();
+
+    void push_back(bool value);
+    void push_front(bool value);
+
+    void pop_back();
+    void pop_front();
+
+    void resize(size_type count, bool value = false);
+
+    void swap(bit_deque& other) noexcept(std::allocator_traits<Allocator>::is_always_equal::value);
+
+    // word-at-a-time algorithms
+
+    // number of set flags
+    size_type count() const;
+    // position of the first set flag, npos if there is none
+    size_type find_first() const;
+    // position of the first set flag after pos, npos if there is none
+    size_type find_next(size_type pos) const;
+
+    // set (reset) the flags in [first, last)
+    void set_range(size_type first, size_type last, bool value = true);
+    void reset_range(size_type first, size_type last);
+
+    // proxy for a single flag
+    class reference {
+       public:
+        reference(const reference&) = default;
+
+        reference& operator=(bool value);
+        reference& operator=(const reference& other);
+
+        operator bool() const;
+        bool operator~() const;
+        void flip();
+
+       private:
+        friend class bit_deque;
+
+        reference(std::uint64_t* word, std::uint64_t mask);
+
+        std::uint64_t* word_;
+        std::uint64_t mask_;
+    };
+
+    // a word iterator and the bit in that word
+    template <bool Const>
+    class Iterator {
+       public:
+        template <bool C>
+        friend class Iterator;
+
+        using value_type = bool;
+        using reference = std::conditional_t<Const, bool, typename bit_deque::reference>;
+        using pointer = void;
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+
+       private:
+        using word_iterator = std::conditional_t<Const, typename deque<std::uint64_t, Allocator>::const_iterator,
+                                                 typename deque<std::uint64_t, Allocator>::iterator>;
+
+       public:
+        Iterator& operator++();
+        Iterator operator++(int);
+        Iterator& operator--();
+        Iterator operator--(int);
+
+        reference operator*() const;
+        reference operator[](difference_type n) const;
+
+        Iterator& operator+=(difference_type n);
+        Iterator& operator-=(difference_type n);
+
+        Iterator operator+(difference_type n) const;
+        Iterator operator-(difference_type n) const;
+
+        friend Iterator operator+(difference_type n, const Iterator& it) { return it + n; }
+
+        difference_type operator-(const Iterator& it) const;
+
+        bool operator==(const Iterator& other) const;
+        std::strong_ordering operator<=>(const Iterator& other) const;
+
+        Iterator() = default;
+        Iterator(word_iterator word, size_type bit);
+
+        template <bool C>
+            requires(Const && !C)
+        Iterator(const Iterator<C>& other);
+
+       private:
+        word_iterator word_{};
+        size_type bit_ = 0;
+    };
+
+    // the 64 flags starting at pos as a word, flag pos in bit 0; the flags past the end are 0
+    std::uint64_t word_at(size_type pos) const;
+
+   private:
+    static constexpr size_type word_bits_ = 64;
+
+    deque<std::uint64_t, Allocator> words_;
+    // bit of words_.front() that holds the first flag, in [0, word_bits_)
+    size_type begin_bit_ = 0;
+    size_type size_ = 0;
+};
+
+template <class Alloc>
+void swap(bit_deque<Alloc>& lhs, bit_deque<Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs)));
+
+template <class Alloc>
+bool operator==(const bit_deque<Alloc>& lhs, const bit_deque<Alloc>& rhs);
+
+template <class Alloc>
+std::strong_ordering operator<=>(const bit_deque<Alloc>& lhs, const bit_deque<Alloc>& rhs);
+
+#include "bit_deque.inl"
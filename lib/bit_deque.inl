@@ -0,0 +1,481 @@
+#pragma once
+#include "bit_deque.h"
+
+template <typename Allocator>
+bit_deque<Allocator>::bit_deque(const Allocator& alloc) : words_(alloc) {}
+
+template <typename Allocator>
+bit_deque<Allocator>::bit_deque(size_type count, bool value, const Allocator& alloc)
+    : words_((count + word_bits_ - 1) / word_bits_, value ? ~std::uint64_t(0) : 0, alloc), size_(count) {
+    if (value && count % word_bits_ != 0) {
+        words_.back() = ~std::uint64_t(0) >> (word_bits_ - count % word_bits_);
+    }
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::bit_deque(std::initializer_list<bool> init, const Allocator& alloc)
+    : bit_deque(init.begin(), init.end(), alloc) {}
+
+template <typename Allocator>
+template <typename InputIt>
+bit_deque<Allocator>::bit_deque(InputIt first, InputIt last, const Allocator& alloc) : words_(alloc) {
+    for (; first != last; ++first) {
+        push_back(static_cast<bool>(*first));
+    }
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::allocator_type bit_deque<Allocator>::get_allocator() const {
+    return words_.get_allocator();
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::reference bit_deque<Allocator>::at(size_type pos) {
+    if (pos >= size_) {
+        deque_throw(std::out_of_range("Index out of range"));
+    }
+    return (*this)[pos];
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::const_reference bit_deque<Allocator>::at(size_type pos) const {
+    if (pos >= size_) {
+        deque_throw(std::out_of_range("Index out of range"));
+    }
+    return (*this)[pos];
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::reference bit_deque<Allocator>::operator[](size_type pos) {
+    size_type bit = begin_bit_ + pos;
+    return reference(&words_[bit / word_bits_], std::uint64_t(1) << (bit % word_bits_));
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::const_reference bit_deque<Allocator>::operator[](size_type pos) const {
+    size_type bit = begin_bit_ + pos;
+    return (words_[bit / word_bits_] >> (bit % word_bits_)) & 1;
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::reference bit_deque<Allocator>::front() {
+    return (*this)[0];
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::const_reference bit_deque<Allocator>::front() const {
+    return (*this)[0];
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::reference bit_deque<Allocator>::back() {
+    return (*this)[size_ - 1];
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::const_reference bit_deque<Allocator>::back() const {
+    return (*this)[size_ - 1];
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::iterator bit_deque<Allocator>::begin() {
+    return iterator(words_.begin(), begin_bit_);
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::const_iterator bit_deque<Allocator>::begin() const {
+    return const_iterator(words_.begin(), begin_bit_);
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::const_iterator bit_deque<Allocator>::cbegin() const noexcept {
+    return begin();
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::iterator bit_deque<Allocator>::end() {
+    size_type bit = begin_bit_ + size_;
+    return iterator(words_.begin() + static_cast<difference_type>(bit / word_bits_), bit % word_bits_);
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::const_iterator bit_deque<Allocator>::end() const {
+    size_type bit = begin_bit_ + size_;
+    return const_iterator(words_.begin() + static_cast<difference_type>(bit / word_bits_), bit % word_bits_);
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::const_iterator bit_deque<Allocator>::cend() const noexcept {
+    return end();
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::reverse_iterator bit_deque<Allocator>::rbegin() {
+    return reverse_iterator(end());
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::const_reverse_iterator bit_deque<Allocator>::rbegin() const {
+    return const_reverse_iterator(end());
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::reverse_iterator bit_deque<Allocator>::rend() {
+    return reverse_iterator(begin());
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::const_reverse_iterator bit_deque<Allocator>::rend() const {
+    return const_reverse_iterator(begin());
+}
+
+template <typename Allocator>
+bool bit_deque<Allocator>::empty() const {
+    return size_ == 0;
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::size_type bit_deque<Allocator>::size() const {
+    return size_;
+}
+
+template <typename Allocator>
+void bit_deque<Allocator>::clear() {
+    words_.clear();
+    begin_bit_ = 0;
+    size_ = 0;
+}
+
+template <typename Allocator>
+void bit_deque<Allocator>::push_back(bool value) {
+    size_type bit = begin_bit_ + size_;
+    if (bit % word_bits_ == 0) {
+        words_.push_back(0);
+    }
+    words_.back() |= std::uint64_t(value) << (bit % word_bits_);
+    ++size_;
+}
+
+template <typename Allocator>
+void bit_deque<Allocator>::push_front(bool value) {
+    if (begin_bit_ == 0) {
+        words_.push_front(0);
+        begin_bit_ = word_bits_;
+    }
+    --begin_bit_;
+    words_.front() |= std::uint64_t(value) << begin_bit_;
+    ++size_;
+}
+
+template <typename Allocator>
+void bit_deque<Allocator>::pop_back() {
+    --size_;
+    size_type bit = begin_bit_ + size_;
+    words_.back() &= ~(std::uint64_t(1) << (bit % word_bits_));
+    if (bit % word_bits_ == 0) {
+        words_.pop_back();
+    }
+}
+
+template <typename Allocator>
+void bit_deque<Allocator>::pop_front() {
+    words_.front() &= ~(std::uint64_t(1) << begin_bit_);
+    --size_;
+    if (++begin_bit_ == word_bits_) {
+        words_.pop_front();
+        begin_bit_ = 0;
+    }
+}
+
+template <typename Allocator>
+void bit_deque<Allocator>::resize(size_type count, bool value) {
+    size_type old_size = size_;
+    size_type end_bit = begin_bit_ + count;
+    words_.resize((end_bit + word_bits_ - 1) / word_bits_, 0);
+    size_ = count;
+    if (count < old_size && end_bit % word_bits_ != 0) {
+        words_.back() &= ~(~std::uint64_t(0) << (end_bit % word_bits_));
+    } else if (count > old_size && value) {
+        set_range(old_size, count);
+    }
+}
+
+template <typename Allocator>
+void bit_deque<Allocator>::swap(bit_deque& other) noexcept(std::allocator_traits<Allocator>::is_always_equal::value) {
+    words_.swap(other.words_);
+    std::swap(begin_bit_, other.begin_bit_);
+    std::swap(size_, other.size_);
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::size_type bit_deque<Allocator>::count() const {
+    size_type cnt = 0;
+    for (std::uint64_t word : words_) {
+        cnt += std::popcount(word);
+    }
+    return cnt;
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::size_type bit_deque<Allocator>::find_first() const {
+    return size_ == 0 ? npos : find_next(npos);
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::size_type bit_deque<Allocator>::find_next(size_type pos) const {
+    // pos == npos starts at the first flag
+    size_type from = pos + 1;
+    if (from >= size_) {
+        return npos;
+    }
+    size_type bit = begin_bit_ + from;
+    auto it = words_.begin() + static_cast<difference_type>(bit / word_bits_);
+    auto last = words_.end();
+    std::uint64_t word = *it & (~std::uint64_t(0) << (bit % word_bits_));
+    while (word == 0) {
+        if (++it == last) {
+            return npos;
+        }
+        word = *it;
+    }
+    return static_cast<size_type>(it - words_.begin()) * word_bits_ + std::countr_zero(word) - begin_bit_;
+}
+
+template <typename Allocator>
+void bit_deque<Allocator>::set_range(size_type first, size_type last, bool value) {
+    if (first >= last) {
+        return;
+    }
+    size_type first_bit = begin_bit_ + first;
+    size_type last_bit = begin_bit_ + last - 1;
+    auto apply = [value](std::uint64_t& word, std::uint64_t mask) {
+        if (value) {
+            word |= mask;
+        } else {
+            word &= ~mask;
+        }
+    };
+    std::uint64_t first_mask = ~std::uint64_t(0) << (first_bit % word_bits_);
+    std::uint64_t last_mask = ~std::uint64_t(0) >> (word_bits_ - 1 - last_bit % word_bits_);
+    auto it = words_.begin() + static_cast<difference_type>(first_bit / word_bits_);
+    size_type words_cnt = last_bit / word_bits_ - first_bit / word_bits_;
+    if (words_cnt == 0) {
+        apply(*it, first_mask & last_mask);
+        return;
+    }
+    apply(*it, first_mask);
+    std::uint64_t fill = value ? ~std::uint64_t(0) : 0;
+    for (++it; --words_cnt > 0; ++it) {
+        *it = fill;
+    }
+    apply(*it, last_mask);
+}
+
+template <typename Allocator>
+void bit_deque<Allocator>::reset_range(size_type first, size_type last) {
+    set_range(first, last, false);
+}
+
+template <typename Allocator>
+std::uint64_t bit_deque<Allocator>::word_at(size_type pos) const {
+    if (pos >= size_) {
+        return 0;
+    }
+    size_type bit = begin_bit_ + pos;
+    size_type ind = bit / word_bits_;
+    size_type shift = bit % word_bits_;
+    auto it = words_.begin() + static_cast<difference_type>(ind);
+    std::uint64_t word = *it >> shift;
+    if (shift != 0 && ind + 1 < words_.size()) {
+        word |= *(it + 1) << (word_bits_ - shift);
+    }
+    return word;
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::reference::reference(std::uint64_t* word, std::uint64_t mask) : word_(word), mask_(mask) {}
+
+template <typename Allocator>
+bit_deque<Allocator>::reference& bit_deque<Allocator>::reference::operator=(bool value) {
+    if (value) {
+        *word_ |= mask_;
+    } else {
+        *word_ &= ~mask_;
+    }
+    return *this;
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::reference& bit_deque<Allocator>::reference::operator=(const reference& other) {
+    return *this = static_cast<bool>(other);
+}
+
+template <typename Allocator>
+bit_deque<Allocator>::reference::operator bool() const {
+    return (*word_ & mask_) != 0;
+}
+
+template <typename Allocator>
+bool bit_deque<Allocator>::reference::operator~() const {
+    return (*word_ & mask_) == 0;
+}
+
+template <typename Allocator>
+void bit_deque<Allocator>::reference::flip() {
+    *word_ ^= mask_;
+}
+
+template <typename Allocator>
+template <bool Const>
+bit_deque<Allocator>::Iterator<Const>::Iterator(word_iterator word, size_type bit) : word_(word), bit_(bit) {}
+
+template <typename Allocator>
+template <bool Const>
+template <bool C>
+    requires(Const && !C)
+bit_deque<Allocator>::Iterator<Const>::Iterator(const Iterator<C>& other) : word_(other.word_), bit_(other.bit_) {}
+
+template <typename Allocator>
+template <bool Const>
+bit_deque<Allocator>::Iterator<Const>& bit_deque<Allocator>::Iterator<Const>::operator++() {
+    if (++bit_ == word_bits_) {
+        bit_ = 0;
+        ++word_;
+    }
+    return *this;
+}
+
+template <typename Allocator>
+template <bool Const>
+bit_deque<Allocator>::Iterator<Const> bit_deque<Allocator>::Iterator<Const>::operator++(int) {
+    Iterator copy = *this;
+    ++*this;
+    return copy;
+}
+
+template <typename Allocator>
+template <bool Const>
+bit_deque<Allocator>::Iterator<Const>& bit_deque<Allocator>::Iterator<Const>::operator--() {
+    if (bit_ == 0) {
+        bit_ = word_bits_;
+        --word_;
+    }
+    --bit_;
+    return *this;
+}
+
+template <typename Allocator>
+template <bool Const>
+bit_deque<Allocator>::Iterator<Const> bit_deque<Allocator>::Iterator<Const>::operator--(int) {
+    Iterator copy = *this;
+    --*this;
+    return copy;
+}
+
+template <typename Allocator>
+template <bool Const>
+bit_deque<Allocator>::Iterator<Const>::reference bit_deque<Allocator>::Iterator<Const>::operator*() const {
+    if constexpr (Const) {
+        return (*word_ >> bit_) & 1;
+    } else {
+        return reference(&*word_, std::uint64_t(1) << bit_);
+    }
+}
+
+template <typename Allocator>
+template <bool Const>
+bit_deque<Allocator>::Iterator<Const>::reference bit_deque<Allocator>::Iterator<Const>::operator[](
+    difference_type n) const {
+    return *(*this + n);
+}
+
+template <typename Allocator>
+template <bool Const>
+bit_deque<Allocator>::Iterator<Const>& bit_deque<Allocator>::Iterator<Const>::operator+=(difference_type n) {
+    // the number of words is rounded towards minus infinity, so that bit_ stays in [0, word_bits_)
+    difference_type bit = static_cast<difference_type>(bit_) + n;
+    constexpr difference_type word_bits = word_bits_;
+    difference_type words = bit >= 0 ? bit / word_bits : -((word_bits - 1 - bit) / word_bits);
+    word_ += words;
+    bit_ = static_cast<size_type>(bit - words * word_bits);
+    return *this;
+}
+
+template <typename Allocator>
+template <bool Const>
+bit_deque<Allocator>::Iterator<Const>& bit_deque<Allocator>::Iterator<Const>::operator-=(difference_type n) {
+    return *this += -n;
+}
+
+template <typename Allocator>
+template <bool Const>
+bit_deque<Allocator>::Iterator<Const> bit_deque<Allocator>::Iterator<Const>::operator+(difference_type n) const {
+    Iterator copy = *this;
+    return copy += n;
+}
+
+template <typename Allocator>
+template <bool Const>
+bit_deque<Allocator>::Iterator<Const> bit_deque<Allocator>::Iterator<Const>::operator-(difference_type n) const {
+    Iterator copy = *this;
+    return copy -= n;
+}
+
+template <typename Allocator>
+template <bool Const>
+bit_deque<Allocator>::Iterator<Const>::difference_type bit_deque<Allocator>::Iterator<Const>::operator-(
+    const Iterator& it) const {
+    return (word_ - it.word_) * static_cast<difference_type>(word_bits_) + static_cast<difference_type>(bit_) -
+           static_cast<difference_type>(it.bit_);
+}
+
+template <typename Allocator>
+template <bool Const>
+bool bit_deque<Allocator>::Iterator<Const>::operator==(const Iterator& other) const {
+    return word_ == other.word_ && bit_ == other.bit_;
+}
+
+template <typename Allocator>
+template <bool Const>
+std::strong_ordering bit_deque<Allocator>::Iterator<Const>::operator<=>(const Iterator& other) const {
+    if (auto cmp = word_ <=> other.word_; cmp != 0) {
+        return cmp;
+    }
+    return bit_ <=> other.bit_;
+}
+
+template <class Alloc>
+void swap(bit_deque<Alloc>& lhs, bit_deque<Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+template <class Alloc>
+bool operator==(const bit_deque<Alloc>& lhs, const bit_deque<Alloc>& rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (typename bit_deque<Alloc>::size_type pos = 0; pos < lhs.size(); pos += 64) {
+        if (lhs.word_at(pos) != rhs.word_at(pos)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class Alloc>
+std::strong_ordering operator<=>(const bit_deque<Alloc>& lhs, const bit_deque<Alloc>& rhs) {
+    // false < true, so the first differing flag decides, and otherwise the shorter deque is less
+    typename bit_deque<Alloc>::size_type common = std::min(lhs.size(), rhs.size());
+    for (typename bit_deque<Alloc>::size_type pos = 0; pos < common; pos += 64) {
+        std::uint64_t lhs_word = lhs.word_at(pos);
+        std::uint64_t diff = lhs_word ^ rhs.word_at(pos);
+        if (common - pos < 64) {
+            diff &= (std::uint64_t(1) << (common - pos)) - 1;
+        }
+        if (diff != 0) {
+            return (lhs_word >> std::countr_zero(diff) & 1) != 0 ? std::strong_ordering::greater
+                                                                  : std::strong_ordering::less;
+        }
+    }
+    return lhs.size() <=> rhs.size();
+}
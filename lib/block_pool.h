@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// keeps freed blocks in a free list per size instead of returning them, so a container that keeps allocating and
+// freeing blocks of the same size (a deque used as a queue) stops allocating once it reaches its peak size.
+// Not thread safe: the owner of the pool synchronizes access to it.
+class block_pool {
+   public:
+    block_pool() = default;
+    block_pool(const block_pool&) = delete;
+    block_pool& operator=(const block_pool&) = delete;
+    ~block_pool();
+
+    void* allocate(std::size_t bytes, std::size_t align);
+    void deallocate(void* block, std::size_t bytes, std::size_t align);
+
+   private:
+    // a freed block keeps the pointer to the next one in its first bytes
+    struct free_list {
+        std::size_t bytes;
+        std::size_t align;
+        void* head;
+    };
+
+    free_list* find(std::size_t bytes, std::size_t align);
+
+    std::vector<free_list> lists_;
+};
+
+// allocator over a block_pool; a default constructed one allocates with operator new
+template <typename T>
+class block_pool_allocator {
+   public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    block_pool_allocator() noexcept = default;
+    explicit block_pool_allocator(block_pool* pool) noexcept;
+
+    template <typename U>
+    block_pool_allocator(const block_pool_allocator<U>& other) noexcept;
+
+    T* allocate(std::size_t n);
+    void deallocate(T* p, std::size_t n);
+
+    block_pool* pool() const noexcept;
+
+    template <typename U>
+    bool operator==(const block_pool_allocator<U>& other) const noexcept;
+
+   private:
+    block_pool* pool_ = nullptr;
+};
+
+#include "block_pool.inl"
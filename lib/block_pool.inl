@@ -0,0 +1,81 @@
+#pragma once
+#include "block_pool.h"
+
+inline block_pool::~block_pool() {
+    for (free_list& list : lists_) {
+        while (list.head != nullptr) {
+            void* next = *static_cast<void**>(list.head);
+            ::operator delete(list.head, std::align_val_t(list.align));
+            list.head = next;
+        }
+    }
+}
+
+inline block_pool::free_list* block_pool::find(std::size_t bytes, std::size_t align) {
+    for (free_list& list : lists_) {
+        if (list.bytes == bytes && list.align == align) {
+            return &list;
+        }
+    }
+    return nullptr;
+}
+
+inline void* block_pool::allocate(std::size_t bytes, std::size_t align) {
+    free_list* list = find(bytes, align);
+    if (list != nullptr && list->head != nullptr) {
+        void* block = list->head;
+        list->head = *static_cast<void**>(block);
+        return block;
+    }
+    if (list == nullptr && bytes >= sizeof(void*)) {
+        // the list is added before the block is allocated, so deallocate always finds it and never allocates
+        lists_.push_back(free_list{bytes, align, nullptr});
+    }
+    return ::operator new(bytes, std::align_val_t(align));
+}
+
+inline void block_pool::deallocate(void* block, std::size_t bytes, std::size_t align) {
+    if (bytes < sizeof(void*)) {
+        ::operator delete(block, std::align_val_t(align));
+        return;
+    }
+    free_list* list = find(bytes, align);
+    *static_cast<void**>(block) = list->head;
+    list->head = block;
+}
+
+template <typename T>
+block_pool_allocator<T>::block_pool_allocator(block_pool* pool) noexcept : pool_(pool) {}
+
+template <typename T>
+template <typename U>
+block_pool_allocator<T>::block_pool_allocator(const block_pool_allocator<U>& other) noexcept
+    : pool_(other.pool()) {}
+
+template <typename T>
+T* block_pool_allocator<T>::allocate(std::size_t n) {
+    if (pool_ == nullptr) {
+        return std::allocator<T>().allocate(n);
+    }
+    return static_cast<T*>(pool_->allocate(n * sizeof(T), alignof(T)));
+}
+
+template <typename T>
+void block_pool_allocator<T>::deallocate(T* p, std::size_t n) {
+    if (pool_ == nullptr) {
+        std::allocator<T>().deallocate(p, n);
+        return;
+    }
+    pool_->deallocate(p, n * sizeof(T), alignof(T));
+}
+
+template <typename T>
+block_pool* block_pool_allocator<T>::pool() const noexcept {
+    return pool_;
+}
+
+template <typename T>
+template <typename U>
+bool block_pool_allocator<T>::operator==(const block_pool_allocator<U>& other) const noexcept {
+    return pool_ == other.pool();
+}
@@ -0,0 +1,155 @@
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "block_pool.h"
+#include "deque.h"
+#include "executor.h"
+
+// queue for coroutines: co_await pop_front() suspends while the channel is empty, and in bounded mode
+// co_await push_back() suspends while it is full. Waiting coroutines are handed their elements directly and are
+// posted to the executor together, one batch per operation. The elements are kept in a deque whose blocks and maps
+// come from a block_pool, so a channel at steady state does not allocate.
+// Executor needs post(std::coroutine_handle<>) and post_batch(std::span<const std::coroutine_handle<>>).
+template <typename T, typename Executor = single_thread_executor>
+class channel {
+   public:
+    class pop_awaiter;
+    class pop_n_awaiter;
+    class push_awaiter;
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    // capacity == 0 makes the channel unbounded
+    explicit channel(Executor& executor, size_type capacity = 0);
+    channel(const channel&) = delete;
+    channel& operator=(const channel&) = delete;
+    // no coroutine may be waiting on the channel
+    ~channel() = default;
+
+    // co_await gives std::optional<T>, std::nullopt once the channel is closed and empty
+    pop_awaiter pop_front();
+    // co_await moves 1..out.size() elements to the beginning of out and gives their number, 0 once the channel is
+    // closed and empty; out must not be empty and is reused between batches, so batched consumption doesn't allocate
+    pop_n_awaiter pop_front_n(std::span<value_type> out);
+    // co_await gives false if the channel is closed
+    push_awaiter push_back(const value_type& value);
+    push_awaiter push_back(value_type&& value);
+
+    // for code outside of coroutines: fail instead of waiting
+    std::optional<value_type> try_pop_front();
+    bool try_push_back(const value_type& value);
+    bool try_push_back(value_type&& value);
+
+    // wakes all waiting coroutines; the elements already in the channel can still be popped
+    void close();
+
+    [[nodiscard]] bool empty() const;
+    size_type size() const;
+    size_type capacity() const;
+    bool closed() const;
+
+   private:
+    using buffer_type = deque<value_type, block_pool_allocator<value_type>>;
+
+    // waiting pop_front/pop_front_n, receive moves its elements from the front of the buffer
+    struct consumer {
+        std::coroutine_handle<> handle;
+        consumer* next = nullptr;
+        void (*receive)(consumer* self, buffer_type& buffer) = nullptr;
+    };
+
+    // waiting push_back, its value goes to the buffer when there is room
+    struct producer {
+        std::coroutine_handle<> handle;
+        producer* next = nullptr;
+        value_type* value = nullptr;
+        bool pushed = false;
+    };
+
+    template <typename Node>
+    struct wait_list {
+        Node* head = nullptr;
+        Node* tail = nullptr;
+
+        void push(Node* node);
+        Node* pop();
+        bool empty() const;
+    };
+
+    bool has_room() const;
+    // hands elements to waiting consumers and room to waiting producers, collecting them in ready_
+    void dispatch();
+    // posts ready_ to the executor, called with the mutex held
+    void flush();
+
+    template <typename U>
+    bool try_push(U&& value);
+
+    Executor& executor_;
+    size_type capacity_;
+    bool closed_ = false;
+    mutable std::mutex mutex_;
+    block_pool pool_;
+    buffer_type buffer_;
+    wait_list<consumer> consumers_;
+    wait_list<producer> producers_;
+    std::vector<std::coroutine_handle<>> ready_;
+
+   public:
+    class pop_awaiter : private consumer {
+       public:
+        explicit pop_awaiter(channel* ch);
+
+        bool await_ready() const noexcept;
+        bool await_suspend(std::coroutine_handle<> handle);
+        std::optional<value_type> await_resume();
+
+       private:
+        static void take(consumer* self, buffer_type& buffer);
+
+        friend class channel;
+        channel* channel_;
+        std::optional<value_type> value_;
+    };
+
+    class pop_n_awaiter : private consumer {
+       public:
+        pop_n_awaiter(channel* ch, std::span<value_type> out);
+
+        bool await_ready() const noexcept;
+        bool await_suspend(std::coroutine_handle<> handle);
+        size_type await_resume() const noexcept;
+
+       private:
+        static void take(consumer* self, buffer_type& buffer);
+
+        friend class channel;
+        channel* channel_;
+        std::span<value_type> out_;
+        size_type cnt_ = 0;
+    };
+
+    class push_awaiter : private producer {
+       public:
+        template <typename U>
+        push_awaiter(channel* ch, U&& value);
+
+        bool await_ready() const noexcept;
+        bool await_suspend(std::coroutine_handle<> handle);
+        bool await_resume() const noexcept;
+
+       private:
+        friend class channel;
+        channel* channel_;
+        value_type stored_;
+    };
+};
+
+#include "channel.inl"
@@ -0,0 +1,279 @@
+#pragma once
+#include "channel.h"
+
+template <typename T, typename Executor>
+channel<T, Executor>::channel(Executor& executor, size_type capacity)
+    : executor_(executor), capacity_(capacity), buffer_(block_pool_allocator<value_type>(&pool_)) {}
+
+template <typename T, typename Executor>
+channel<T, Executor>::pop_awaiter channel<T, Executor>::pop_front() {
+    return pop_awaiter(this);
+}
+
+template <typename T, typename Executor>
+channel<T, Executor>::pop_n_awaiter channel<T, Executor>::pop_front_n(std::span<value_type> out) {
+    return pop_n_awaiter(this, out);
+}
+
+template <typename T, typename Executor>
+channel<T, Executor>::push_awaiter channel<T, Executor>::push_back(const value_type& value) {
+    return push_awaiter(this, value);
+}
+
+template <typename T, typename Executor>
+channel<T, Executor>::push_awaiter channel<T, Executor>::push_back(value_type&& value) {
+    return push_awaiter(this, std::move(value));
+}
+
+template <typename T, typename Executor>
+std::optional<T> channel<T, Executor>::try_pop_front() {
+    std::lock_guard lock(mutex_);
+    if (buffer_.empty()) {
+        return std::nullopt;
+    }
+    std::optional<value_type> value(std::move(buffer_.front()));
+    buffer_.pop_front();
+    dispatch();
+    flush();
+    return value;
+}
+
+template <typename T, typename Executor>
+bool channel<T, Executor>::try_push_back(const value_type& value) {
+    return try_push(value);
+}
+
+template <typename T, typename Executor>
+bool channel<T, Executor>::try_push_back(value_type&& value) {
+    return try_push(std::move(value));
+}
+
+template <typename T, typename Executor>
+template <typename U>
+bool channel<T, Executor>::try_push(U&& value) {
+    std::lock_guard lock(mutex_);
+    if (closed_ || !has_room()) {
+        return false;
+    }
+    buffer_.push_back(std::forward<U>(value));
+    dispatch();
+    flush();
+    return true;
+}
+
+template <typename T, typename Executor>
+void channel<T, Executor>::close() {
+    std::lock_guard lock(mutex_);
+    closed_ = true;
+    // consumers only wait on an empty channel, they get nothing
+    while (!consumers_.empty()) {
+        ready_.push_back(consumers_.pop()->handle);
+    }
+    while (!producers_.empty()) {
+        producer* waiting = producers_.pop();
+        waiting->pushed = false;
+        ready_.push_back(waiting->handle);
+    }
+    flush();
+}
+
+template <typename T, typename Executor>
+bool channel<T, Executor>::empty() const {
+    std::lock_guard lock(mutex_);
+    return buffer_.empty();
+}
+
+template <typename T, typename Executor>
+channel<T, Executor>::size_type channel<T, Executor>::size() const {
+    std::lock_guard lock(mutex_);
+    return buffer_.size();
+}
+
+template <typename T, typename Executor>
+channel<T, Executor>::size_type channel<T, Executor>::capacity() const {
+    return capacity_;
+}
+
+template <typename T, typename Executor>
+bool channel<T, Executor>::closed() const {
+    std::lock_guard lock(mutex_);
+    return closed_;
+}
+
+template <typename T, typename Executor>
+bool channel<T, Executor>::has_room() const {
+    return capacity_ == 0 || buffer_.size() < capacity_;
+}
+
+template <typename T, typename Executor>
+void channel<T, Executor>::dispatch() {
+    // admitting producers may feed consumers that were waiting, so repeat until neither side can move
+    bool moved = true;
+    while (moved) {
+        moved = false;
+        while (!consumers_.empty() && !buffer_.empty()) {
+            consumer* waiting = consumers_.pop();
+            waiting->receive(waiting, buffer_);
+            ready_.push_back(waiting->handle);
+            moved = true;
+        }
+        while (!producers_.empty() && has_room()) {
+            producer* waiting = producers_.pop();
+            buffer_.push_back(std::move(*waiting->value));
+            waiting->pushed = true;
+            ready_.push_back(waiting->handle);
+            moved = true;
+        }
+    }
+}
+
+template <typename T, typename Executor>
+void channel<T, Executor>::flush() {
+    if (!ready_.empty()) {
+        executor_.post_batch(ready_);
+        // the capacity stays, so the next batches don't allocate
+        ready_.clear();
+    }
+}
+
+template <typename T, typename Executor>
+template <typename Node>
+void channel<T, Executor>::wait_list<Node>::push(Node* node) {
+    node->next = nullptr;
+    if (tail == nullptr) {
+        head = node;
+    } else {
+        tail->next = node;
+    }
+    tail = node;
+}
+
+template <typename T, typename Executor>
+template <typename Node>
+Node* channel<T, Executor>::wait_list<Node>::pop() {
+    Node* node = head;
+    head = node->next;
+    if (head == nullptr) {
+        tail = nullptr;
+    }
+    return node;
+}
+
+template <typename T, typename Executor>
+template <typename Node>
+bool channel<T, Executor>::wait_list<Node>::empty() const {
+    return head == nullptr;
+}
+
+template <typename T, typename Executor>
+channel<T, Executor>::pop_awaiter::pop_awaiter(channel* ch) : channel_(ch) {
+    this->receive = &take;
+}
+
+template <typename T, typename Executor>
+bool channel<T, Executor>::pop_awaiter::await_ready() const noexcept {
+    // the check is done in await_suspend, under the mutex
+    return false;
+}
+
+template <typename T, typename Executor>
+bool channel<T, Executor>::pop_awaiter::await_suspend(std::coroutine_handle<> handle) {
+    std::lock_guard lock(channel_->mutex_);
+    if (!channel_->buffer_.empty()) {
+        take(this, channel_->buffer_);
+        channel_->dispatch();
+        channel_->flush();
+        return false;
+    }
+    if (channel_->closed_) {
+        return false;
+    }
+    this->handle = handle;
+    channel_->consumers_.push(this);
+    return true;
+}
+
+template <typename T, typename Executor>
+std::optional<T> channel<T, Executor>::pop_awaiter::await_resume() {
+    return std::move(value_);
+}
+
+template <typename T, typename Executor>
+void channel<T, Executor>::pop_awaiter::take(consumer* self, buffer_type& buffer) {
+    auto* awaiter = static_cast<pop_awaiter*>(self);
+    awaiter->value_.emplace(std::move(buffer.front()));
+    buffer.pop_front();
+}
+
+template <typename T, typename Executor>
+channel<T, Executor>::pop_n_awaiter::pop_n_awaiter(channel* ch, std::span<value_type> out) : channel_(ch), out_(out) {
+    this->receive = &take;
+}
+
+template <typename T, typename Executor>
+bool channel<T, Executor>::pop_n_awaiter::await_ready() const noexcept {
+    return false;
+}
+
+template <typename T, typename Executor>
+bool channel<T, Executor>::pop_n_awaiter::await_suspend(std::coroutine_handle<> handle) {
+    std::lock_guard lock(channel_->mutex_);
+    if (!channel_->buffer_.empty()) {
+        take(this, channel_->buffer_);
+        channel_->dispatch();
+        channel_->flush();
+        return false;
+    }
+    if (channel_->closed_) {
+        return false;
+    }
+    this->handle = handle;
+    channel_->consumers_.push(this);
+    return true;
+}
+
+template <typename T, typename Executor>
+channel<T, Executor>::size_type channel<T, Executor>::pop_n_awaiter::await_resume() const noexcept {
+    return cnt_;
+}
+
+template <typename T, typename Executor>
+void channel<T, Executor>::pop_n_awaiter::take(consumer* self, buffer_type& buffer) {
+    auto* awaiter = static_cast<pop_n_awaiter*>(self);
+    awaiter->cnt_ = buffer.drain_front(awaiter->out_.data(), awaiter->out_.size());
+}
+
+template <typename T, typename Executor>
+template <typename U>
+channel<T, Executor>::push_awaiter::push_awaiter(channel* ch, U&& value)
+    : channel_(ch), stored_(std::forward<U>(value)) {}
+
+template <typename T, typename Executor>
+bool channel<T, Executor>::push_awaiter::await_ready() const noexcept {
+    return false;
+}
+
+template <typename T, typename Executor>
+bool channel<T, Executor>::push_awaiter::await_suspend(std::coroutine_handle<> handle) {
+    std::lock_guard lock(channel_->mutex_);
+    if (channel_->closed_) {
+        this->pushed = false;
+        return false;
+    }
+    if (channel_->has_room()) {
+        channel_->buffer_.push_back(std::move(stored_));
+        this->pushed = true;
+        channel_->dispatch();
+        channel_->flush();
+        return false;
+    }
+    this->handle = handle;
+    this->value = &stored_;
+    channel_->producers_.push(this);
+    return true;
+}
+
+template <typename T, typename Executor>
+bool channel<T, Executor>::push_awaiter::await_resume() const noexcept {
+    return this->pushed;
+}
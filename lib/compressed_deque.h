@@ -0,0 +1,102 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "deque.h"
+
+static inline const size_t compressed_deque_block_size = 1024;
+
+// std::make_unsigned_t isn't defined for bool
+template <typename T>
+concept compressed_deque_value = std::integral<T> && !std::same_as<T, bool>;
+
+// deque of integers that keeps the elements near the ends uncompressed and stores the interior in sealed blocks of
+// compressed_deque_block_size elements, each one bit-packed either as offsets from its minimum (frame of reference)
+// or as deltas between neighbours, whichever is smaller. Each end keeps up to two blocks unpacked, so pushes and pops
+// that alternate around a block boundary don't seal and unseal a block every time
+template <compressed_deque_value T>
+class compressed_deque {
+   public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    compressed_deque() = default;
+
+    // elements are returned by value, they may have to be decoded
+    value_type at(size_type pos) const;
+    value_type operator[](size_type pos) const;
+
+    value_type front() const;
+    value_type back() const;
+
+    [[nodiscard]] bool empty() const;
+    size_type size() const;
+
+    // bytes of heap memory taken by the elements
+    size_type memory_bytes() const;
+
+    void clear();
+
+    void push_back(value_type value);
+    void push_front(value_type value);
+
+    void pop_back();
+    void pop_front();
+
+    // calls func(std::span<const T>) for consecutive parts of the elements in order, decoding a sealed block at a time
+    template <typename Func>
+    void for_each_block(Func&& func) const;
+
+   private:
+    using U = std::make_unsigned_t<T>;
+
+    static constexpr size_type block_size_ = compressed_deque_block_size;
+    // delta encoded blocks keep every anchor_step_-th element, so random access sums at most anchor_step_ deltas
+    static constexpr size_type anchor_step_ = 64;
+    // words taken by the anchors at the beginning of the data of a delta encoded block
+    static constexpr size_type anchor_words_ = (block_size_ / anchor_step_ * sizeof(T) + 7) / 8;
+
+    enum class encoding : std::uint8_t { frame_of_reference, delta };
+
+    struct sealed_block {
+        encoding enc;
+        std::uint8_t width;  // bits per packed value
+        T base;              // the minimum of the packed values
+        T first;             // the first element
+        // a single allocation: for delta encoding the anchors (elements 0, anchor_step_, 2 * anchor_step_, ...)
+        // take the first anchor_words_ words, the packed values follow
+        std::vector<std::uint64_t> data;
+    };
+
+    static const std::uint64_t* packed_words(const sealed_block& block);
+    static T anchor(const sealed_block& block, size_type ind);
+
+    static sealed_block seal(const T* values);
+    static void unseal(const sealed_block& block, T* out);
+    static T decode_one(const sealed_block& block, size_type ind);
+
+    static void pack(const U* values, size_type cnt, std::uint8_t width, std::uint64_t* words);
+    static U unpack_one(const std::uint64_t* words, std::uint8_t width, size_type ind);
+
+    template <std::size_t Width>
+    static void unpack_fixed(const std::uint64_t* words, U base, T* out, size_type cnt);
+    template <std::size_t... Widths>
+    static void unpack(const std::uint64_t* words, std::uint8_t width, U base, T* out, size_type cnt,
+                       std::index_sequence<Widths...>);
+
+    // head_ holds the first elements in reverse order, so both ends grow at the back of a vector; each holds at most
+    // 2 * block_size_ elements
+    std::vector<T> head_;
+    deque<sealed_block> sealed_;
+    std::vector<T> tail_;
+};
+
+#include "compressed_deque.inl"
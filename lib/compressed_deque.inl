@@ -0,0 +1,298 @@
+#pragma once
+#include "compressed_deque.h"
+
+template <compressed_deque_value T>
+compressed_deque<T>::value_type compressed_deque<T>::operator[](size_type pos) const {
+    if (pos < head_.size()) {
+        return head_[head_.size() - 1 - pos];
+    }
+    pos -= head_.size();
+    if (pos < sealed_.size() * block_size_) {
+        return decode_one(sealed_[pos / block_size_], pos % block_size_);
+    }
+    return tail_[pos - sealed_.size() * block_size_];
+}
+
+template <compressed_deque_value T>
+compressed_deque<T>::value_type compressed_deque<T>::at(size_type pos) const {
+    if (pos >= size()) {
+        deque_throw(std::out_of_range("The size of container is smaller than the numbers in the function argument"));
+    }
+    return this->operator[](pos);
+}
+
+template <compressed_deque_value T>
+compressed_deque<T>::value_type compressed_deque<T>::front() const {
+    if (!head_.empty()) {
+        return head_.back();
+    }
+    if (!sealed_.empty()) {
+        return sealed_.front().first;
+    }
+    return tail_.front();
+}
+
+template <compressed_deque_value T>
+compressed_deque<T>::value_type compressed_deque<T>::back() const {
+    if (!tail_.empty()) {
+        return tail_.back();
+    }
+    if (!sealed_.empty()) {
+        return decode_one(sealed_.back(), block_size_ - 1);
+    }
+    return head_.front();
+}
+
+template <compressed_deque_value T>
+bool compressed_deque<T>::empty() const {
+    return size() == 0;
+}
+
+template <compressed_deque_value T>
+compressed_deque<T>::size_type compressed_deque<T>::size() const {
+    return head_.size() + sealed_.size() * block_size_ + tail_.size();
+}
+
+template <compressed_deque_value T>
+compressed_deque<T>::size_type compressed_deque<T>::memory_bytes() const {
+    size_type bytes = (head_.capacity() + tail_.capacity()) * sizeof(T) + sealed_.size() * sizeof(sealed_block);
+    for (const auto& block : sealed_) {
+        bytes += block.data.capacity() * sizeof(std::uint64_t);
+    }
+    return bytes;
+}
+
+template <compressed_deque_value T>
+void compressed_deque<T>::clear() {
+    head_.clear();
+    sealed_.clear();
+    tail_.clear();
+}
+
+template <compressed_deque_value T>
+void compressed_deque<T>::push_back(value_type value) {
+    if (tail_.size() == 2 * block_size_) {
+        // the older block is sealed, the newer one stays unpacked for the pops that may follow
+        sealed_.push_back(seal(tail_.data()));
+        tail_.erase(tail_.begin(), tail_.begin() + block_size_);
+    }
+    tail_.push_back(value);
+}
+
+template <compressed_deque_value T>
+void compressed_deque<T>::push_front(value_type value) {
+    if (head_.size() == 2 * block_size_) {
+        std::array<T, block_size_> values;
+        std::reverse_copy(head_.begin(), head_.begin() + block_size_, values.begin());
+        sealed_.push_front(seal(values.data()));
+        head_.erase(head_.begin(), head_.begin() + block_size_);
+    }
+    head_.push_back(value);
+}
+
+template <compressed_deque_value T>
+void compressed_deque<T>::pop_back() {
+    if (tail_.empty()) {
+        // the last sealed block is unpacked, or half of the head is moved over when there is none
+        if (!sealed_.empty()) {
+            tail_.resize(block_size_);
+            unseal(sealed_.back(), tail_.data());
+            sealed_.pop_back();
+        } else {
+            auto half = head_.begin() + static_cast<std::ptrdiff_t>((head_.size() + 1) / 2);
+            tail_.assign(std::make_reverse_iterator(half), head_.rend());
+            head_.erase(head_.begin(), half);
+        }
+    }
+    tail_.pop_back();
+}
+
+template <compressed_deque_value T>
+void compressed_deque<T>::pop_front() {
+    if (head_.empty()) {
+        if (!sealed_.empty()) {
+            std::array<T, block_size_> values;
+            unseal(sealed_.front(), values.data());
+            head_.assign(values.rbegin(), values.rend());
+            sealed_.pop_front();
+        } else {
+            auto half = tail_.begin() + static_cast<std::ptrdiff_t>((tail_.size() + 1) / 2);
+            head_.assign(std::make_reverse_iterator(half), tail_.rend());
+            tail_.erase(tail_.begin(), half);
+        }
+    }
+    head_.pop_back();
+}
+
+template <compressed_deque_value T>
+template <typename Func>
+void compressed_deque<T>::for_each_block(Func&& func) const {
+    std::array<T, block_size_> values;
+    // head_ is reversed into values a block at a time, starting from its end
+    for (size_type left = head_.size(); left != 0;) {
+        size_type cnt = std::min(left, block_size_);
+        std::reverse_copy(head_.begin() + (left - cnt), head_.begin() + left, values.begin());
+        func(std::span<const T>(values.data(), cnt));
+        left -= cnt;
+    }
+    for (const auto& block : sealed_) {
+        unseal(block, values.data());
+        func(std::span<const T>(values.data(), block_size_));
+    }
+    if (!tail_.empty()) {
+        func(std::span<const T>(tail_.data(), tail_.size()));
+    }
+}
+
+template <compressed_deque_value T>
+const std::uint64_t* compressed_deque<T>::packed_words(const sealed_block& block) {
+    return block.data.data() + (block.enc == encoding::delta ? anchor_words_ : 0);
+}
+
+template <compressed_deque_value T>
+T compressed_deque<T>::anchor(const sealed_block& block, size_type ind) {
+    T value;
+    std::memcpy(&value, reinterpret_cast<const std::byte*>(block.data.data()) + ind * sizeof(T), sizeof(T));
+    return value;
+}
+
+template <compressed_deque_value T>
+compressed_deque<T>::sealed_block compressed_deque<T>::seal(const T* values) {
+    // values holds block_size_ elements, the arithmetic is done on unsigned values so that it wraps around
+    std::array<U, block_size_> packed;
+
+    auto [min_it, max_it] = std::minmax_element(values, values + block_size_);
+    std::uint8_t for_width = std::bit_width(static_cast<U>(static_cast<U>(*max_it) - static_cast<U>(*min_it)));
+
+    T delta_min = static_cast<T>(static_cast<U>(values[1]) - static_cast<U>(values[0]));
+    T delta_max = delta_min;
+    for (size_type i = 1; i < block_size_; ++i) {
+        T delta = static_cast<T>(static_cast<U>(values[i]) - static_cast<U>(values[i - 1]));
+        delta_min = std::min(delta_min, delta);
+        delta_max = std::max(delta_max, delta);
+    }
+    std::uint8_t delta_width = std::bit_width(static_cast<U>(static_cast<U>(delta_max) - static_cast<U>(delta_min)));
+
+    sealed_block block;
+    block.first = values[0];
+    size_type cnt;
+    if (delta_width < for_width) {
+        block.enc = encoding::delta;
+        block.width = delta_width;
+        block.base = delta_min;
+        cnt = block_size_ - 1;
+        for (size_type i = 0; i < cnt; ++i) {
+            packed[i] = static_cast<U>(values[i + 1]) - static_cast<U>(values[i]) - static_cast<U>(delta_min);
+        }
+    } else {
+        block.enc = encoding::frame_of_reference;
+        block.width = for_width;
+        block.base = *min_it;
+        cnt = block_size_;
+        for (size_type i = 0; i < cnt; ++i) {
+            packed[i] = static_cast<U>(values[i]) - static_cast<U>(*min_it);
+        }
+    }
+    size_type anchor_words = block.enc == encoding::delta ? anchor_words_ : 0;
+    // one more word, so that a value is always read from two words
+    size_type words = block.width != 0 ? (cnt * block.width + 63) / 64 + 1 : 0;
+    if (anchor_words + words != 0) {
+        block.data.assign(anchor_words + words, 0);
+    }
+    if (block.enc == encoding::delta) {
+        for (size_type i = 0; i < block_size_ / anchor_step_; ++i) {
+            std::memcpy(reinterpret_cast<std::byte*>(block.data.data()) + i * sizeof(T), values + i * anchor_step_,
+                        sizeof(T));
+        }
+    }
+    if (words != 0) {
+        pack(packed.data(), cnt, block.width, block.data.data() + anchor_words);
+    }
+    return block;
+}
+
+template <compressed_deque_value T>
+void compressed_deque<T>::unseal(const sealed_block& block, T* out) {
+    constexpr auto widths = std::make_index_sequence<sizeof(U) * 8 + 1>();
+    if (block.enc == encoding::frame_of_reference) {
+        unpack(packed_words(block), block.width, static_cast<U>(block.base), out, block_size_, widths);
+        return;
+    }
+    out[0] = block.first;
+    unpack(packed_words(block), block.width, static_cast<U>(block.base), out + 1, block_size_ - 1, widths);
+    for (size_type i = 1; i < block_size_; ++i) {
+        out[i] = static_cast<T>(static_cast<U>(out[i - 1]) + static_cast<U>(out[i]));
+    }
+}
+
+template <compressed_deque_value T>
+T compressed_deque<T>::decode_one(const sealed_block& block, size_type ind) {
+    if (block.enc == encoding::frame_of_reference) {
+        return static_cast<T>(static_cast<U>(block.base) + unpack_one(packed_words(block), block.width, ind));
+    }
+    // only the deltas between the closest anchor and ind are summed
+    const std::uint64_t* words = packed_words(block);
+    U value = static_cast<U>(anchor(block, ind / anchor_step_));
+    for (size_type i = ind / anchor_step_ * anchor_step_; i < ind; ++i) {
+        value += static_cast<U>(block.base) + unpack_one(words, block.width, i);
+    }
+    return static_cast<T>(value);
+}
+
+template <compressed_deque_value T>
+void compressed_deque<T>::pack(const U* values, size_type cnt, std::uint8_t width, std::uint64_t* words) {
+    for (size_type i = 0; i < cnt; ++i) {
+        size_type bit = i * width;
+        size_type shift = bit % 64;
+        std::uint64_t value = values[i];
+        words[bit / 64] |= value << shift;
+        if (shift + width > 64) {
+            words[bit / 64 + 1] |= value >> (64 - shift);
+        }
+    }
+}
+
+template <compressed_deque_value T>
+compressed_deque<T>::U compressed_deque<T>::unpack_one(const std::uint64_t* words, std::uint8_t width,
+                                                       size_type ind) {
+    if (width == 0) {
+        return 0;
+    }
+    size_type bit = ind * width;
+    size_type shift = bit % 64;
+    std::uint64_t value = words[bit / 64] >> shift;
+    if (shift + width > 64) {
+        value |= words[bit / 64 + 1] << (64 - shift);
+    }
+    std::uint64_t mask = width == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << width) - 1;
+    return static_cast<U>(value & mask);
+}
+
+template <compressed_deque_value T>
+template <std::size_t Width>
+void compressed_deque<T>::unpack_fixed(const std::uint64_t* words, U base, T* out, size_type cnt) {
+    // Width is a constant here, so the compiler unrolls and vectorizes the loop
+    if constexpr (Width == 0) {
+        std::fill(out, out + cnt, static_cast<T>(base));
+    } else {
+        constexpr std::uint64_t mask = Width == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << Width) - 1;
+        for (size_type i = 0; i < cnt; ++i) {
+            size_type bit = i * Width;
+            size_type shift = bit % 64;
+            std::uint64_t value = words[bit / 64] >> shift;
+            if constexpr (64 % Width != 0) {
+                if (shift + Width > 64) {
+                    value |= words[bit / 64 + 1] << (64 - shift);
+                }
+            }
+            out[i] = static_cast<T>(static_cast<U>(base + static_cast<U>(value & mask)));
+        }
+    }
+}
+
+template <compressed_deque_value T>
+template <std::size_t... Widths>
+void compressed_deque<T>::unpack(const std::uint64_t* words, std::uint8_t width, U base, T* out, size_type cnt,
+                                 std::index_sequence<Widths...>) {
+    ((width == Widths ? unpack_fixed<Widths>(words, base, out, cnt) : void()), ...);
+}
@@ -0,0 +1,155 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "deque.h"
+
+// deque whose blocks are shared between copies through reference counts: copying it (snapshot()) costs
+// O(number of blocks), and a block is cloned only when a copy changes an element that another copy can see.
+// A copy may be read on another thread while the original is modified; modifying two copies that share blocks at
+// the same time needs external synchronization.
+template <typename T>
+class cow_deque {
+   public:
+    class const_iterator;
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    cow_deque() = default;
+    cow_deque(std::initializer_list<value_type> init);
+
+    // copies share all blocks
+    cow_deque(const cow_deque& other) = default;
+    cow_deque(cow_deque&& other) noexcept;
+
+    cow_deque& operator=(const cow_deque& other) = default;
+    cow_deque& operator=(cow_deque&& other) noexcept;
+
+    cow_deque snapshot() const;
+
+    // the non-const accessors clone the block of the element if it is shared
+    reference at(size_type pos);
+    const_reference at(size_type pos) const;
+
+    reference operator[](size_type pos);
+    const_reference operator[](size_type pos) const;
+
+    reference front();
+    const_reference front() const;
+
+    reference back();
+    const_reference back() const;
+
+    const_iterator begin() const;
+    const_iterator cbegin() const noexcept;
+
+    const_iterator end() const;
+    const_iterator cend() const noexcept;
+
+    const_reverse_iterator rbegin() const;
+    const_reverse_iterator rend() const;
+
+    [[nodiscard]] bool empty() const;
+    size_type size() const;
+
+    // number of blocks that are also used by another copy
+    size_type shared_blocks() const;
+
+    void clear();
+
+    void push_back(const value_type& value);
+    void push_back(value_type&& value);
+
+    template <class... Args>
+    reference emplace_back(Args&&... args);
+
+    void pop_back();
+
+    void push_front(const value_type& value);
+    void push_front(value_type&& value);
+
+    template <class... Args>
+    reference emplace_front(Args&&... args);
+
+    void pop_front();
+
+    class const_iterator {
+       public:
+        using value_type = T;
+        using reference = const T&;
+        using pointer = const T*;
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+
+        const_iterator& operator++();
+        const_iterator operator++(int);
+        const_iterator& operator--();
+        const_iterator operator--(int);
+
+        reference operator*() const;
+        pointer operator->() const;
+        reference operator[](difference_type n) const;
+
+        const_iterator& operator+=(difference_type n);
+        const_iterator& operator-=(difference_type n);
+
+        const_iterator operator+(difference_type n) const;
+        const_iterator operator-(difference_type n) const;
+
+        friend const_iterator operator+(difference_type n, const const_iterator& it) { return it + n; }
+
+        difference_type operator-(const const_iterator& it) const;
+
+        bool operator==(const const_iterator& other) const;
+        std::strong_ordering operator<=>(const const_iterator& other) const;
+
+        const_iterator() = default;
+        const_iterator(const cow_deque* container, difference_type ind);
+
+       private:
+        const cow_deque* container_ = nullptr;
+        difference_type ind_ = 0;
+    };
+
+   private:
+    static constexpr size_type block_size_ = sizeof(T) > deque_buffer_size ? 1 : deque_buffer_size / sizeof(T);
+
+    // [lo_, hi_) are the constructed elements, the union of what the owners can see
+    struct block {
+        alignas(T) std::byte storage_[block_size_ * sizeof(T)];
+        size_type lo_ = 0;
+        size_type hi_ = 0;
+
+        T* slot(size_type ind);
+        ~block();
+    };
+
+    using block_pointer = std::shared_ptr<block>;
+
+    // elements of this copy in nodes_[node]
+    size_type view_first(size_type node) const;
+    size_type view_last(size_type node) const;
+    bool is_shared(const block_pointer& node) const;
+    // makes nodes_[node] hold exactly the elements this copy sees and no other copy use it
+    void own(size_type node);
+    void locate(size_type pos, size_type& node, size_type& ind) const;
+
+    deque<block_pointer> nodes_;
+    size_type begin_ind_ = 0;  // position of the first element in nodes_.front()
+    size_type size_ = 0;
+};
+
+#include "cow_deque.inl"
@@ -0,0 +1,387 @@
+#pragma once
+#include "cow_deque.h"
+
+template <typename T>
+T* cow_deque<T>::block::slot(size_type ind) {
+    return std::launder(reinterpret_cast<T*>(storage_) + ind);
+}
+
+template <typename T>
+cow_deque<T>::block::~block() {
+    for (size_type i = lo_; i < hi_; ++i) {
+        std::destroy_at(slot(i));
+    }
+}
+
+template <typename T>
+cow_deque<T>::cow_deque(std::initializer_list<value_type> init) {
+    for (const auto& value : init) {
+        emplace_back(value);
+    }
+}
+
+template <typename T>
+cow_deque<T>::cow_deque(cow_deque&& other) noexcept
+    : nodes_(std::move(other.nodes_)),
+      begin_ind_(std::exchange(other.begin_ind_, 0)),
+      size_(std::exchange(other.size_, 0)) {}
+
+template <typename T>
+cow_deque<T>& cow_deque<T>::operator=(cow_deque&& other) noexcept {
+    if (this != &other) {
+        nodes_ = std::move(other.nodes_);
+        begin_ind_ = std::exchange(other.begin_ind_, 0);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+template <typename T>
+cow_deque<T> cow_deque<T>::snapshot() const {
+    return *this;
+}
+
+template <typename T>
+cow_deque<T>::size_type cow_deque<T>::view_first(size_type node) const {
+    return node == 0 ? begin_ind_ : 0;
+}
+
+template <typename T>
+cow_deque<T>::size_type cow_deque<T>::view_last(size_type node) const {
+    return std::min(block_size_, begin_ind_ + size_ - node * block_size_);
+}
+
+template <typename T>
+bool cow_deque<T>::is_shared(const block_pointer& node) const {
+    if (node.use_count() > 1) {
+        return true;
+    }
+    // the other owners are gone, their reads of the block happen before our writes
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return false;
+}
+
+template <typename T>
+void cow_deque<T>::own(size_type node) {
+    size_type first = view_first(node);
+    size_type last = view_last(node);
+    block_pointer& curr = nodes_[node];
+    if (is_shared(curr)) {
+        auto copy = std::make_shared<block>();
+        copy->lo_ = first;
+        copy->hi_ = first;
+        for (; copy->hi_ < last; ++copy->hi_) {
+            std::construct_at(copy->slot(copy->hi_), *curr->slot(copy->hi_));
+        }
+        curr = std::move(copy);
+        return;
+    }
+    // elements left by copies that are gone
+    for (; curr->lo_ < first; ++curr->lo_) {
+        std::destroy_at(curr->slot(curr->lo_));
+    }
+    for (; curr->hi_ > last; --curr->hi_) {
+        std::destroy_at(curr->slot(curr->hi_ - 1));
+    }
+}
+
+template <typename T>
+void cow_deque<T>::locate(size_type pos, size_type& node, size_type& ind) const {
+    pos += begin_ind_;
+    node = pos / block_size_;
+    ind = pos % block_size_;
+}
+
+template <typename T>
+cow_deque<T>::reference cow_deque<T>::operator[](size_type pos) {
+    size_type node;
+    size_type ind;
+    locate(pos, node, ind);
+    own(node);
+    return *nodes_[node]->slot(ind);
+}
+
+template <typename T>
+cow_deque<T>::const_reference cow_deque<T>::operator[](size_type pos) const {
+    size_type node;
+    size_type ind;
+    locate(pos, node, ind);
+    return *nodes_[node]->slot(ind);
+}
+
+template <typename T>
+cow_deque<T>::reference cow_deque<T>::at(size_type pos) {
+    if (pos >= size_) {
+        deque_throw(std::out_of_range("The size of container is smaller than the numbers in the function argument"));
+    }
+    return this->operator[](pos);
+}
+
+template <typename T>
+cow_deque<T>::const_reference cow_deque<T>::at(size_type pos) const {
+    if (pos >= size_) {
+        deque_throw(std::out_of_range("The size of container is smaller than the numbers in the function argument"));
+    }
+    return this->operator[](pos);
+}
+
+template <typename T>
+cow_deque<T>::reference cow_deque<T>::front() {
+    return this->operator[](0);
+}
+
+template <typename T>
+cow_deque<T>::const_reference cow_deque<T>::front() const {
+    return this->operator[](0);
+}
+
+template <typename T>
+cow_deque<T>::reference cow_deque<T>::back() {
+    return this->operator[](size_ - 1);
+}
+
+template <typename T>
+cow_deque<T>::const_reference cow_deque<T>::back() const {
+    return this->operator[](size_ - 1);
+}
+
+template <typename T>
+cow_deque<T>::const_iterator cow_deque<T>::begin() const {
+    return const_iterator(this, 0);
+}
+
+template <typename T>
+cow_deque<T>::const_iterator cow_deque<T>::cbegin() const noexcept {
+    return const_iterator(this, 0);
+}
+
+template <typename T>
+cow_deque<T>::const_iterator cow_deque<T>::end() const {
+    return const_iterator(this, size_);
+}
+
+template <typename T>
+cow_deque<T>::const_iterator cow_deque<T>::cend() const noexcept {
+    return const_iterator(this, size_);
+}
+
+template <typename T>
+cow_deque<T>::const_reverse_iterator cow_deque<T>::rbegin() const {
+    return const_reverse_iterator(end());
+}
+
+template <typename T>
+cow_deque<T>::const_reverse_iterator cow_deque<T>::rend() const {
+    return const_reverse_iterator(begin());
+}
+
+template <typename T>
+bool cow_deque<T>::empty() const {
+    return size_ == 0;
+}
+
+template <typename T>
+cow_deque<T>::size_type cow_deque<T>::size() const {
+    return size_;
+}
+
+template <typename T>
+cow_deque<T>::size_type cow_deque<T>::shared_blocks() const {
+    return std::count_if(nodes_.begin(), nodes_.end(), [](const block_pointer& node) { return node.use_count() > 1; });
+}
+
+template <typename T>
+void cow_deque<T>::clear() {
+    nodes_.clear();
+    begin_ind_ = 0;
+    size_ = 0;
+}
+
+template <typename T>
+void cow_deque<T>::push_back(const value_type& value) {
+    emplace_back(value);
+}
+
+template <typename T>
+void cow_deque<T>::push_back(value_type&& value) {
+    emplace_back(std::move(value));
+}
+
+template <typename T>
+template <class... Args>
+cow_deque<T>::reference cow_deque<T>::emplace_back(Args&&... args) {
+    size_type node;
+    size_type ind;
+    locate(size_, node, ind);
+    if (node == nodes_.size()) {
+        // the element is constructed before the block is linked, so an exception leaves the deque unchanged
+        auto fresh = std::make_shared<block>();
+        T* el = std::construct_at(fresh->slot(ind), std::forward<Args>(args)...);
+        fresh->lo_ = ind;
+        fresh->hi_ = ind + 1;
+        nodes_.push_back(std::move(fresh));
+        ++size_;
+        return *el;
+    }
+    if (nodes_[node]->hi_ != ind) {
+        // the slot holds an element another copy can see
+        own(node);
+    }
+    block& curr = *nodes_[node];
+    T* el = std::construct_at(curr.slot(ind), std::forward<Args>(args)...);
+    ++curr.hi_;
+    ++size_;
+    return *el;
+}
+
+template <typename T>
+void cow_deque<T>::pop_back() {
+    size_type node;
+    size_type ind;
+    locate(size_ - 1, node, ind);
+    if (!is_shared(nodes_[node])) {
+        own(node);
+        std::destroy_at(nodes_[node]->slot(ind));
+        --nodes_[node]->hi_;
+    }
+    --size_;
+    if (size_ == 0) {
+        clear();
+    } else if (ind == 0) {
+        nodes_.pop_back();
+    }
+}
+
+template <typename T>
+void cow_deque<T>::push_front(const value_type& value) {
+    emplace_front(value);
+}
+
+template <typename T>
+void cow_deque<T>::push_front(value_type&& value) {
+    emplace_front(std::move(value));
+}
+
+template <typename T>
+template <class... Args>
+cow_deque<T>::reference cow_deque<T>::emplace_front(Args&&... args) {
+    if (nodes_.empty() || begin_ind_ == 0) {
+        auto fresh = std::make_shared<block>();
+        T* el = std::construct_at(fresh->slot(block_size_ - 1), std::forward<Args>(args)...);
+        fresh->lo_ = block_size_ - 1;
+        fresh->hi_ = block_size_;
+        nodes_.push_front(std::move(fresh));
+        begin_ind_ = block_size_ - 1;
+        ++size_;
+        return *el;
+    }
+    if (nodes_.front()->lo_ != begin_ind_) {
+        own(0);
+    }
+    block& curr = *nodes_.front();
+    T* el = std::construct_at(curr.slot(begin_ind_ - 1), std::forward<Args>(args)...);
+    --curr.lo_;
+    --begin_ind_;
+    ++size_;
+    return *el;
+}
+
+template <typename T>
+void cow_deque<T>::pop_front() {
+    if (!is_shared(nodes_.front())) {
+        own(0);
+        std::destroy_at(nodes_.front()->slot(begin_ind_));
+        ++nodes_.front()->lo_;
+    }
+    ++begin_ind_;
+    --size_;
+    if (size_ == 0) {
+        clear();
+    } else if (begin_ind_ == block_size_) {
+        nodes_.pop_front();
+        begin_ind_ = 0;
+    }
+}
+
+template <typename T>
+cow_deque<T>::const_iterator::const_iterator(const cow_deque* container, difference_type ind)
+    : container_(container), ind_(ind) {}
+
+template <typename T>
+cow_deque<T>::const_iterator& cow_deque<T>::const_iterator::operator++() {
+    ++ind_;
+    return *this;
+}
+
+template <typename T>
+cow_deque<T>::const_iterator cow_deque<T>::const_iterator::operator++(int) {
+    const_iterator tmp = *this;
+    ++ind_;
+    return tmp;
+}
+
+template <typename T>
+cow_deque<T>::const_iterator& cow_deque<T>::const_iterator::operator--() {
+    --ind_;
+    return *this;
+}
+
+template <typename T>
+cow_deque<T>::const_iterator cow_deque<T>::const_iterator::operator--(int) {
+    const_iterator tmp = *this;
+    --ind_;
+    return tmp;
+}
+
+template <typename T>
+cow_deque<T>::const_iterator::reference cow_deque<T>::const_iterator::operator*() const {
+    return (*container_)[ind_];
+}
+
+template <typename T>
+cow_deque<T>::const_iterator::pointer cow_deque<T>::const_iterator::operator->() const {
+    return &(*container_)[ind_];
+}
+
+template <typename T>
+cow_deque<T>::const_iterator::reference cow_deque<T>::const_iterator::operator[](difference_type n) const {
+    return (*container_)[ind_ + n];
+}
+
+template <typename T>
+cow_deque<T>::const_iterator& cow_deque<T>::const_iterator::operator+=(difference_type n) {
+    ind_ += n;
+    return *this;
+}
+
+template <typename T>
+cow_deque<T>::const_iterator& cow_deque<T>::const_iterator::operator-=(difference_type n) {
+    ind_ -= n;
+    return *this;
+}
+
+template <typename T>
+cow_deque<T>::const_iterator cow_deque<T>::const_iterator::operator+(difference_type n) const {
+    return const_iterator(container_, ind_ + n);
+}
+
+template <typename T>
+cow_deque<T>::const_iterator cow_deque<T>::const_iterator::operator-(difference_type n) const {
+    return const_iterator(container_, ind_ - n);
+}
+
+template <typename T>
+cow_deque<T>::const_iterator::difference_type cow_deque<T>::const_iterator::operator-(
+    const const_iterator& it) const {
+    return ind_ - it.ind_;
+}
+
+template <typename T>
+bool cow_deque<T>::const_iterator::operator==(const const_iterator& other) const {
+    return ind_ == other.ind_;
+}
+
+template <typename T>
+std::strong_ordering cow_deque<T>::const_iterator::operator<=>(const const_iterator& other) const {
+    return ind_ <=> other.ind_;
+}
@@ -1,12 +1,81 @@
 #pragma once
 #include <algorithm>
+#include <bit>
+#include <compare>
 #include <cmath>
 #include <concepts>
-#include <iostream>
+#include <functional>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
 #include <iterator>
 #include <memory>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 static inline const size_t deque_buffer_size = 512;
+// limits of a block size picked per instance
+static inline const size_t deque_max_buffer_bytes = size_t(1) << 20;
+// with an adaptive block size the blocks double once the deque would span more than this many of them
+static inline const size_t deque_blocks_before_growth = 16;
+
+// block size of a deque instance in elements, 0 means the default of deque_buffer_size bytes. With max greater
+// than initial the block size is adaptive: it doubles as the deque grows, up to max, and the elements are moved to
+// the new blocks, so push_back/push_front don't keep references valid then. It never shrinks.
+struct deque_block_size {
+    size_t initial = 0;
+    size_t max = 0;
+};
+
+// deque::sort sorts the elements in groups of about this many bytes before merging the groups
+static inline const size_t deque_sort_run_bytes = size_t(1) << 18;
+
+// number of threads for deque::sort and stable_sort, 0 means std::thread::hardware_concurrency()
+struct deque_sort_threads {
+    size_t count = 0;
+};
+
+// node-wise traversal prefetches the block this many blocks ahead, 0 turns prefetching off. Iterators prefetch
+// (ahead when incremented, behind when decremented) only with DEQUE_PREFETCH_ITERATORS=1: in bench/prefetch_bench
+// their prefetching helped some scans and slowed down others
+#ifndef DEQUE_PREFETCH_DISTANCE
+#define DEQUE_PREFETCH_DISTANCE 4
+#endif
+#ifndef DEQUE_PREFETCH_ITERATORS
+#define DEQUE_PREFETCH_ITERATORS 0
+#endif
+static inline constexpr size_t deque_prefetch_distance = DEQUE_PREFETCH_DISTANCE;
+static inline constexpr bool deque_prefetch_iterators = DEQUE_PREFETCH_ITERATORS;
+
+// DEQUE_NO_EXCEPTIONS=1 (the default with -fno-exceptions) compiles the rollback code out, and errors that would
+// throw call std::abort. The rollback code is also left out where it can't run: emplace, erase and moving between
+// nodes have no try blocks when the constructors and assignments they use are noexcept
+#ifndef DEQUE_NO_EXCEPTIONS
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+#define DEQUE_NO_EXCEPTIONS 0
+#else
+#define DEQUE_NO_EXCEPTIONS 1
+#endif
+#endif
+static inline constexpr bool deque_exceptions = !DEQUE_NO_EXCEPTIONS;
+
+#if DEQUE_NO_EXCEPTIONS
+#define DEQUE_TRY if constexpr (true)
+#define DEQUE_CATCH if constexpr (false)
+#define DEQUE_RETHROW std::abort()
+#else
+#define DEQUE_TRY try
+#define DEQUE_CATCH catch (...)
+#define DEQUE_RETHROW throw
+#endif
+
+// throws exception, or aborts without exceptions
+template <typename Exception>
+[[noreturn]] void deque_throw(const Exception& exception);
 
 template <typename T, typename Allocator = std::allocator<T>>
 class deque {
@@ -19,7 +88,7 @@ class deque {
     using size_type = std::size_t;
     using difference_type = std::ptrdiff_t;
     using reference = T&;
-    using const_reference = const reference;
+    using const_reference = const value_type&;
     using pointer = std::allocator_traits<Allocator>::pointer;
     using const_pointer = std::allocator_traits<Allocator>::const_pointer;
     using iterator_category = std::random_access_iterator_tag;
@@ -31,6 +100,7 @@ class deque {
 
     deque();
     explicit deque(const Allocator& alloc);
+    explicit deque(deque_block_size block_size, const Allocator& alloc = Allocator());
     explicit deque(size_type count, const Allocator& alloc = Allocator());
     deque(size_type count, const T& value, const Allocator& alloc = Allocator());
 
@@ -38,7 +108,7 @@ class deque {
     deque(InputIt first, InputIt last, const Allocator& alloc = Allocator());
 
     deque(const deque& other);
-    deque(deque&& other);
+    deque(deque&& other) noexcept;
 
 #if __cplusplus >= 202002L
     deque(const deque& other, const std::type_identity_t<Allocator>& alloc);
@@ -95,6 +165,8 @@ class deque {
     [[nodiscard]] bool empty() const;
     size_type size() const;
     size_type max_size() const;
+    // elements per block
+    size_type block_size() const;
     void shrink_to_fit();
 
     void clear();
@@ -114,6 +186,16 @@ class deque {
     iterator erase(const_iterator pos);
     iterator erase(const_iterator first, const_iterator last);
 
+    // remove the elements for which pred is true (all but the first of each run of equal elements for unique, pred
+    // must be an equivalence relation) in a single pass over the blocks, return the number of removed elements
+    template <class Pred>
+    size_type remove_if(Pred pred);
+
+    size_type unique();
+
+    template <class BinaryPred>
+    size_type unique(BinaryPred pred);
+
     void push_back(const value_type& value);
     void push_back(value_type&& value);
 
@@ -129,23 +211,89 @@ class deque {
     reference emplace_front(Args&&... args);
 
     void pop_front();
+
+    // remove count elements (count <= size()) node by node, releasing the emptied nodes
+    void pop_front_n(size_type count);
+    void pop_back_n(size_type count);
+
+    // move up to max_cnt elements from the beginning to out and remove them, returns the number of moved elements
+    size_type drain_front(value_type* out, size_type max_cnt);
+
+    template <class OutputIt>
+    size_type drain_front(OutputIt out, size_type max_cnt);
+
+    class segment_view;
+
+    // append (prepend) count value-initialized elements and return the contiguous spans covering them, the caller
+    // writes into the spans and then calls commit_back(k) (commit_front(k)) to keep k of them: the first k for
+    // grow_back, the last k for grow_front; nothing else may modify the deque in between
+    segment_view grow_back(size_type count);
+    segment_view grow_front(size_type count);
+
+    // the same without initializing the elements, only for trivially default constructible types
+    segment_view grow_back_for_overwrite(size_type count);
+    segment_view grow_front_for_overwrite(size_type count);
+
+    void commit_back(size_type count);
+    void commit_front(size_type count);
+
     void resize(size_type count);
     void resize(size_type count, const value_type& value);
 
     void swap(deque& other) noexcept(std::allocator_traits<Allocator>::is_always_equal::value);
 
+    // sort groups of nodes in a scratch buffer of deque_sort_run_bytes (or each node in place if it is larger), then
+    // merge the sorted groups pairwise node by node into the blocks the merged groups release, so the merge needs a
+    // few extra blocks. Integers compared with std::less or std::greater are radix sorted through a buffer of size()
+    // elements instead. Types that may throw on move are sorted with std::sort / std::stable_sort over the iterators
+    template <typename Compare = std::less<>>
+    void sort(Compare comp = Compare());
+    template <typename Compare = std::less<>>
+    void stable_sort(Compare comp = Compare());
+
+    // the same with the groups and the merges of a pass spread over threads; the allocator and comp must be safe to
+    // use from several threads
+    template <typename Compare = std::less<>>
+    void sort(deque_sort_threads threads, Compare comp = Compare());
+    template <typename Compare = std::less<>>
+    void stable_sort(deque_sort_threads threads, Compare comp = Compare());
+
+    // binary search in a sorted deque: over the first elements of the nodes, then inside a single node
+    template <typename K, typename Compare = std::less<>>
+    iterator lower_bound(const K& key, Compare comp = Compare());
+    template <typename K, typename Compare = std::less<>>
+    const_iterator lower_bound(const K& key, Compare comp = Compare()) const;
+
+    template <typename K, typename Compare = std::less<>>
+    iterator upper_bound(const K& key, Compare comp = Compare());
+    template <typename K, typename Compare = std::less<>>
+    const_iterator upper_bound(const K& key, Compare comp = Compare()) const;
+
+    template <typename K, typename Compare = std::less<>>
+    std::pair<iterator, iterator> equal_range(const K& key, Compare comp = Compare());
+    template <typename K, typename Compare = std::less<>>
+    std::pair<const_iterator, const_iterator> equal_range(const K& key, Compare comp = Compare()) const;
+
+    // inserts value after the equal elements of a sorted deque
+    template <typename Compare = std::less<>>
+    iterator insert_sorted(const T& value, Compare comp = Compare());
+    template <typename Compare = std::less<>>
+    iterator insert_sorted(T&& value, Compare comp = Compare());
+
+    // moves [pos, end()) into a new deque: whole nodes are handed over, only the node containing pos is copied
+    deque split(const_iterator pos);
+
     template <typename Tp>
     class Iterator {
        public:
         template <typename U>
         friend class Iterator;
 
-        using value_type = Tp;
-        using reference = value_type&;
-        using const_reference = const reference;
-        using pointer = value_type*;
-        using const_pointer = const pointer;
+        using value_type = std::remove_cv_t<Tp>;
+        using reference = Tp&;
+        using pointer = Tp*;
         using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
         using difference_type = std::ptrdiff_t;
 
        private:
@@ -153,62 +301,172 @@ class deque {
         using map_pointer = el_pointer*;
 
        public:
-        value_type operator++(int);
-        reference operator++();
-        value_type operator--(int);
-        reference operator--();
+        Iterator& operator++();
+        Iterator operator++(int);
+        Iterator& operator--();
+        Iterator operator--(int);
+
+        reference operator*() const;
+        pointer operator->() const;
+        reference operator[](difference_type n) const;
 
-        reference operator*();
-        const_reference operator*() const;
+        Iterator& operator+=(difference_type n);
+        Iterator& operator-=(difference_type n);
 
-        pointer operator->();
-        const_pointer operator->() const;
+        Iterator operator+(difference_type n) const;
+        Iterator operator-(difference_type n) const;
 
-        Iterator operator+(difference_type n);
-        Iterator operator-(difference_type n);
+        friend Iterator operator+(difference_type n, const Iterator& it) { return it + n; }
 
         template <typename U>
         difference_type operator-(const Iterator<U>& it) const;
 
         bool operator==(const Iterator& other) const;
-        bool operator!=(const Iterator& other) const;
+        std::strong_ordering operator<=>(const Iterator& other) const;
 
         Iterator() = default;
         Iterator(el_pointer start, el_pointer curr, el_pointer finish, map_pointer curr_node);
-        Iterator(const Iterator& other);
-        Iterator operator=(const Iterator& other);
-        Iterator(Iterator&& other);
-        Iterator operator=(Iterator&& other);
 
+        // const_iterator is converted back to iterator only explicitly
         template <typename U>
-        Iterator(const Iterator<U>& other);
+        explicit(std::is_const_v<U> && !std::is_const_v<Tp>) Iterator(const Iterator<U>& other);
 
        private:
-        el_pointer start_el_ = nullptr;
+        friend class deque;
+
+        void set_node(map_pointer node, difference_type sz);
+        difference_type node_size() const;
+
+        // on an unallocated node (end() right after a full node, or an empty deque) start_el_ and curr_el_ are null
+        // and finish_el_ holds the node size as an integer, so that no offset is added to nullptr
         el_pointer curr_el_ = nullptr;
+        el_pointer start_el_ = nullptr;
         el_pointer finish_el_ = nullptr;
         map_pointer curr_node_ = nullptr;
     };
 
+    // range of std::span<T> over count consecutive elements, one span per node
+    class segment_view {
+       public:
+        class iterator {
+           public:
+            using value_type = std::span<T>;
+            using difference_type = std::ptrdiff_t;
+            using iterator_category = std::forward_iterator_tag;
+
+            iterator() = default;
+            iterator(pointer* node, size_type ind, size_type left, size_type buffer_size);
+
+            value_type operator*() const;
+            iterator& operator++();
+            iterator operator++(int);
+            bool operator==(const iterator& other) const;
+
+           private:
+            pointer* node_ = nullptr;
+            size_type ind_ = 0;
+            size_type left_ = 0;
+            size_type buffer_size_ = 0;
+        };
+
+        segment_view(pointer* node, size_type ind, size_type count, size_type buffer_size);
+
+        iterator begin() const;
+        iterator end() const;
+
+        // number of elements covered by the spans
+        size_type size() const;
+
+       private:
+        pointer* node_;
+        size_type ind_;
+        size_type count_;
+        size_type buffer_size_;
+    };
+
+    template <class U, class A>
+    friend bool operator==(const deque<U, A>& lhs, const deque<U, A>& rhs);
+
+    template <class U, class A>
+    friend constexpr auto operator<=>(const deque<U, A>& lhs, const deque<U, A>& rhs);
+
+    friend struct std::hash<deque>;
+
    private:
     using map_pointer = pointer*;
     using PMapAlloc = typename std::allocator_traits<Allocator>::rebind_alloc<pointer>;
     using alloc_traits = std::allocator_traits<Allocator>;
     using pmap_alloc_traits = std::allocator_traits<PMapAlloc>;
 
+    // elements can be copied with memcpy instead of alloc_traits::construct
+    static constexpr bool bitwise_copyable_ =
+        std::is_trivially_copyable_v<T> && !requires(Allocator& a, T* p, const T& v) { a.construct(p, v); };
+    // equal elements have equal bytes, so ranges can be compared with memcmp and hashed as bytes
+    static constexpr bool bytewise_comparable_ = std::is_scalar_v<T> && std::has_unique_object_representations_v<T>;
+    // value-initialized elements can be created with memset
+    static constexpr bool zero_fillable_ = std::is_arithmetic_v<T> && !requires(Allocator& a, T* p) { a.construct(p); };
+
     explicit deque(const Allocator& alloc, const PMapAlloc& pmap_alloc);
 
     template <typename InputIt>
     deque(InputIt first, InputIt last, const Allocator& alloc, const PMapAlloc& pmap_alloc);
 
+    // map shared by all empty deques, so the empty state owns no memory; its slots are never written.
+    // Other maps have deque_prefetch_distance extra null slots on each side, so traversal can read the node
+    // deque_prefetch_distance ahead of any live node without a bounds check
+    inline static pointer empty_map_[2] = {};
+
     static size_t deque_buffer_sz(size_t sz);
+    // requests the first deque_buffer_size bytes of block into the cache; block may be nullptr. Always inlined:
+    // otherwise GCC sees a function without side effects and drops the calls
+    [[gnu::always_inline]] static inline void prefetch_node(const void* block, size_type bytes);
     void default_constr_with_memory_cap(size_type nodes_cnt, size_type borders_offset = 1);
+    map_pointer allocate_map(size_type nodes_cnt);
+    void deallocate_map();
+    void deallocate_map(map_pointer start, map_pointer finish);
     void reallocate_pointers_map(size_type offset_borders = 0);
+    // takes the block size of other, *this must be empty without nodes
+    void adopt_block_size(const deque& other);
+    // the block size that an adaptive deque should have to hold size() + extra elements
+    size_type grown_buffer_size(size_type extra) const;
+    // moves the elements to blocks of new_buffer_size elements
+    void reblock(size_type new_buffer_size);
     void shrink_to_fit_nodes();
+    // move-constructs cnt elements into raw memory, nothing stays constructed there if an exception is thrown
     void move_nodes(map_pointer new_begin, size_type new_begin_ind, map_pointer old_begin, size_type old_begin_ind,
                     size_type cnt);
 
+    void destroy_range(pointer first, pointer last);
+
+    template <typename InputIt>
+    InputIt construct_range(pointer dest, InputIt first, size_type cnt);
+
+    template <typename... Args>
+    void fill_range(pointer dest, size_type cnt, const Args&... args);
+
+    template <typename InputIt>
+    InputIt append_n(InputIt first, size_type cnt);
+
+    template <typename Func>
+    void append_nodes(size_type cnt, Func&& construct);
+    template <typename Func>
+    void prepend_nodes(size_type cnt, Func&& construct);
     void destroy_node(map_pointer node, size_type first_ind, size_type last_ind);
+    void deallocate_node(map_pointer node);
+
+    iterator make_iterator(map_pointer node, size_type ind) const;
+    void locate(size_type pos, map_pointer& node, size_type& ind) const;
+
+    template <typename Func>
+    void for_each_segment(size_type pos, size_type cnt, Func&& func) const;
+
+    // calls func(first, last, other_first) for the chunks of the first cnt elements that are contiguous in both *this
+    // and other, in order, until it returns false; returns false if it did
+    template <typename Func>
+    bool for_each_common_segment(const deque& other, size_type cnt, Func&& func) const;
+
+    template <typename Pred>
+    iterator partition_point_nodes(Pred pred) const;
 
     template <typename Func>
     iterator insert_front(const_iterator pos, size_type cnt, Func&& get_value);
@@ -219,15 +477,64 @@ class deque {
     iterator erase_front(const_iterator first, const_iterator last);
     iterator erase_back(const_iterator first, const_iterator last);
 
+    template <typename Compare>
+    static constexpr bool radix_sortable_ =
+        std::is_integral_v<T> && !std::is_same_v<T, bool> && bitwise_copyable_ &&
+        (std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>> ||
+         std::is_same_v<Compare, std::greater<>> || std::is_same_v<Compare, std::greater<T>>);
+    // below this size a radix sort doesn't pay for its counting
+    static constexpr size_type radix_sort_min_ = 1024;
+
+    // blocks released by the merged groups, reused for the merged ones; merge_runs needs at most
+    // sort_spare_blocks_ of them besides those it releases
+    static constexpr size_type sort_spare_blocks_ = 3;
+    struct sort_spares {
+        pointer blocks[sort_spare_blocks_ + 1];
+        size_type cnt = 0;
+    };
+
+    // first and last index of the elements in the node-th live node
+    size_type node_begin(size_type node) const;
+    size_type node_end(size_type node) const;
+
+    // calls func(first, last) for consecutive parts of [0, cnt) on up to threads_cnt threads, including the calling
+    // one, and rethrows the first exception after all parts are done
+    template <typename Func>
+    static void run_parallel(size_type cnt, size_type threads_cnt, Func&& func);
+
+    template <bool Stable, typename Compare>
+    void sort_nodes(Compare& comp, size_type threads_cnt);
+    // sorts the elements of the nodes [first, last) (counted from curr_begin_node_) in scratch
+    template <bool Stable, typename Compare>
+    void sort_run(size_type first, size_type last, pointer scratch, Compare& comp);
+    // merges the sorted nodes [first, middle) and [middle, last) into blocks stored to out[first, last); on an
+    // exception the elements are still moved there, in unspecified order
+    template <typename Compare>
+    void merge_runs(size_type first, size_type middle, size_type last, map_pointer out, sort_spares& spares,
+                    Compare& comp);
+    pointer take_spare(sort_spares& spares);
+    void release_spare(sort_spares& spares, pointer block);
+    // move-constructs cnt elements at dest from src and destroys them there
+    void relocate(pointer dest, pointer src, size_type cnt);
+    template <bool Descending>
+    void radix_sort();
+
+    // keeps the elements for which drop(element, last) is false, moving them towards the front, and pops the rest;
+    // last is nullptr for the first element and otherwise points to the last kept element or to one equal to it under
+    // an equivalence relation; returns the number of popped elements
+    template <typename Pred>
+    size_type compact(Pred drop);
+
     void swap_elemets(value_type& first, value_type& second);
 
     void next_element(map_pointer& node, size_type& ind);
     void prev_element(map_pointer& node, size_type& ind);
 
     template <typename... Args>
-    void resize_templ(size_type cnt, Args... args);
+    void resize_templ(size_type cnt, const Args&... args);
 
     void move_assign_each_element_individually(deque&& other);
+    void copy_nodes(const deque& other);
     void copy_assign_each_element_individually(const deque& other);
 
     PMapAlloc get_pmap_allocator() const;
@@ -244,6 +551,11 @@ class deque {
     size_type end_ind_;
 
     size_t buffer_size_;
+    size_t max_buffer_size_;  // greater than buffer_size_ for the adaptive block size
+
+    // elements added by the last grow_back/grow_front and not committed yet
+    size_type grown_back_ = 0;
+    size_type grown_front_ = 0;
 
     [[no_unique_address]] Allocator alloc_;
     [[no_unique_address]] PMapAlloc pmap_alloc_;  // аллокатор, управляющий памятью для мапы указателей
@@ -269,4 +581,31 @@ typename deque<T, Alloc>::size_type erase(deque<T, Alloc>& c, const U& value);
 template <class T, class Alloc, class Pred>
 typename deque<T, Alloc>::size_type erase_if(deque<T, Alloc>& c, Pred pred);
 
+// streaming 64-bit hash; the result depends only on the sequence of bytes and words added, not on how the bytes are
+// split between add_bytes calls
+class deque_hash_state {
+   public:
+    void add_bytes(const void* data, std::size_t bytes);
+    void add_word(std::uint64_t word);
+    std::size_t finish();
+
+   private:
+    static constexpr std::size_t lanes_cnt_ = 4;
+    static std::uint64_t mix(std::uint64_t lane, std::uint64_t word);
+
+    // word i goes to lane i % lanes_cnt_
+    std::uint64_t lanes_[lanes_cnt_] = {0x243F6A8885A308D3, 0x13198A2E03707344, 0xA4093822299F31D0, 0x082EFA98EC4E6C89};
+    std::uint64_t count_ = 0;
+    unsigned char pending_[8] = {};
+    std::size_t pending_bytes_ = 0;
+};
+
+// hashes the elements block by block, as bytes if they are bytewise comparable; equal deques hash equally whatever
+// their block sizes and offsets
+template <class T, class Alloc>
+    requires requires(const T& value) { std::hash<T>{}(value); }
+struct std::hash<deque<T, Alloc>> {
+    std::size_t operator()(const deque<T, Alloc>& d) const;
+};
+
 #include "deque.inl"
\ No newline at end of file
@@ -1,11 +1,21 @@
 #pragma once
 #include "deque.h"
 
+template <typename Exception>
+void deque_throw(const Exception& exception) {
+#if DEQUE_NO_EXCEPTIONS
+    (void)exception;
+    std::abort();
+#else
+    throw exception;
+#endif
+}
+
 template <typename T, typename Allocator>
 deque<T, Allocator>::deque() : deque(Allocator()){};
 
 template <typename T, typename Allocator>
-deque<T, Allocator>::deque(const Allocator& alloc) : deque(alloc, PMapAlloc()) {}
+deque<T, Allocator>::deque(const Allocator& alloc) : deque(alloc, PMapAlloc(alloc)) {}
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::deque(const Allocator& alloc, const PMapAlloc& pmap_alloc)
@@ -17,16 +27,38 @@ deque<T, Allocator>::deque(const Allocator& alloc, const PMapAlloc& pmap_alloc)
       curr_end_node_(nullptr),
       begin_ind_(0),
       end_ind_(0),
-      buffer_size_(deque_buffer_sz(sizeof(T)))
+      buffer_size_(deque_buffer_sz(sizeof(T))),
+      max_buffer_size_(buffer_size_)
 
 {
     default_constr_with_memory_cap(0);
 }
 
+template <typename T, typename Allocator>
+deque<T, Allocator>::deque(deque_block_size block_size, const Allocator& alloc) : deque(alloc) {
+    size_type limit = std::max<size_type>(1, deque_max_buffer_bytes / sizeof(T));
+    if (block_size.initial != 0) {
+        buffer_size_ = std::clamp<size_type>(block_size.initial, 1, limit);
+    }
+    max_buffer_size_ = block_size.max == 0 ? buffer_size_ : std::clamp<size_type>(block_size.max, buffer_size_, limit);
+    end_ind_ = buffer_size_;
+}
+
 template <typename T, typename Allocator>
 void deque<T, Allocator>::default_constr_with_memory_cap(size_type nodes_cnt, size_type borders_offset) {
     // creates an empty deque with storage capacity
-    start_node_ = pmap_alloc_traits::allocate(pmap_alloc_, nodes_cnt + borders_offset * 2);
+    if (nodes_cnt == 0) {
+        // curr_begin_node_ == start_node_ and finish_node_ - curr_end_node_ == 2, so the first push at either end
+        // reallocates the map before anything is written to it
+        start_node_ = empty_map_ + 1;
+        finish_node_ = empty_map_ + 2;
+        curr_begin_node_ = start_node_;
+        curr_end_node_ = empty_map_;
+        begin_ind_ = 0;
+        end_ind_ = buffer_size_;
+        return;
+    }
+    start_node_ = allocate_map(nodes_cnt + borders_offset * 2);
     finish_node_ = start_node_ + nodes_cnt + borders_offset * 2;
     curr_begin_node_ = start_node_ + borders_offset;
     curr_end_node_ = curr_begin_node_ - 1;
@@ -35,81 +67,234 @@ void deque<T, Allocator>::default_constr_with_memory_cap(size_type nodes_cnt, si
 }
 
 template <typename T, typename Allocator>
-deque<T, Allocator>::deque(size_type count, const Allocator& alloc)
-    : alloc_(alloc), buffer_size_(deque_buffer_sz(sizeof(T))), pmap_alloc_(PMapAlloc()) {
+deque<T, Allocator>::map_pointer deque<T, Allocator>::allocate_map(size_type nodes_cnt) {
+    // every node outside of [curr_begin_node_, curr_end_node_] holds nullptr
+    map_pointer map = pmap_alloc_traits::allocate(pmap_alloc_, nodes_cnt + 2 * deque_prefetch_distance);
+    for (size_type i = 0; i < nodes_cnt + 2 * deque_prefetch_distance; ++i) {
+        pmap_alloc_traits::construct(pmap_alloc_, map + i, nullptr);
+    }
+    return map + deque_prefetch_distance;
+}
+
+template <typename T, typename Allocator>
+void deque<T, Allocator>::deallocate_map() {
+    if (start_node_ == empty_map_ + 1) {
+        return;
+    }
+    deallocate_map(start_node_, finish_node_);
+}
+
+template <typename T, typename Allocator>
+void deque<T, Allocator>::deallocate_map(map_pointer start, map_pointer finish) {
+    map_pointer map = start - deque_prefetch_distance;
+    size_type nodes_cnt = finish - start + 2 * deque_prefetch_distance;
+    for (map_pointer node = map; node != map + nodes_cnt; ++node) {
+        pmap_alloc_traits::destroy(pmap_alloc_, node);
+    }
+    pmap_alloc_traits::deallocate(pmap_alloc_, map, nodes_cnt);
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::deque(size_type count, const Allocator& alloc) : deque(alloc, PMapAlloc(alloc)) {
     static_assert(std::is_default_constructible_v<T>, "The stored value must have default constructor.");
 
     size_type sz = count / buffer_size_ + (count % buffer_size_ == 0 ? 0 : 1);
+    deallocate_map();
     default_constr_with_memory_cap(sz);
-    size_type i;
-    try {
-        for (i = 0; i < count; ++i) {
-            emplace_back(T());
-        }
-    } catch (const std::exception& e) {
-        for (size_type j = 0; j < i; ++j) {
-            pop_back();
-        }
-        pmap_alloc_traits::deallocate(pmap_alloc_, start_node_, sz + 2);
-    }
+    append_nodes(count, [this](pointer dest, size_type cnt) { fill_range(dest, cnt); });
 }
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::deque(size_type count, const T& value, const Allocator& alloc)
-    : alloc_(alloc), buffer_size_(deque_buffer_sz(sizeof(T))), pmap_alloc_(PMapAlloc()) {
+    : deque(alloc, PMapAlloc(alloc)) {
     static_assert(std::is_copy_constructible_v<T>, "The stored value must have copy constructor.");
 
     size_type sz = count / buffer_size_ + (count % buffer_size_ == 0 ? 0 : 1);
+    deallocate_map();
     default_constr_with_memory_cap(sz);
-
-    size_type i;
-    try {
-        for (i = 0; i < count; ++i) {
-            emplace_back(value);
-        }
-    } catch (const std::exception& e) {
-        for (size_type j = 0; j < i; ++j) {
-            pop_back();
-        }
-        std::cerr << e.what() << '\n';
-    }
+    append_nodes(count, [this, &value](pointer dest, size_type cnt) { fill_range(dest, cnt, value); });
 }
 
 template <typename T, typename Allocator>
 template <typename InputIt>
 deque<T, Allocator>::deque(InputIt first, InputIt last, const Allocator& alloc)
-    : deque(first, last, alloc, PMapAlloc()) {}
+    : deque(first, last, alloc, PMapAlloc(alloc)) {}
 
 template <typename T, typename Allocator>
 template <typename InputIt>
 deque<T, Allocator>::deque(InputIt first, InputIt last, const Allocator& alloc, const PMapAlloc& pmap_alloc)
-    : alloc_(alloc), buffer_size_(deque_buffer_sz(sizeof(T))), pmap_alloc_(pmap_alloc) {
-    size_type el_cnt = last - first;
-    size_type nodes_cnt = el_cnt / buffer_size_ + el_cnt % buffer_size_ + 2;
+    : deque(alloc, pmap_alloc) {
+    if constexpr (std::forward_iterator<InputIt>) {
+        size_type el_cnt = std::distance(first, last);
+        size_type nodes_cnt = el_cnt / buffer_size_ + (el_cnt % buffer_size_ == 0 ? 0 : 1);
+
+        deallocate_map();
+        default_constr_with_memory_cap(nodes_cnt);
+        append_n(first, el_cnt);
+    } else {
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+}
 
+template <typename T, typename Allocator>
+deque<T, Allocator>::deque(const deque& other)
+    : deque(alloc_traits::select_on_container_copy_construction(other.alloc_),
+            pmap_alloc_traits::select_on_container_copy_construction(other.pmap_alloc_)) {
+    copy_nodes(other);
+}
+
+template <typename T, typename Allocator>
+void deque<T, Allocator>::copy_nodes(const deque& other) {
+    // clones every node of an other deque into an empty one, keeping the positions of elements inside the nodes
+    adopt_block_size(other);
+    if (other.empty()) {
+        return;
+    }
+    size_type nodes_cnt = other.curr_end_node_ - other.curr_begin_node_ + 1;
+    deallocate_map();
     default_constr_with_memory_cap(nodes_cnt);
-    size_type i = 0;
-    try {
-        for (auto it = first; it != last; ++i, ++it) {
-            emplace_back(*it);
+    begin_ind_ = other.begin_ind_;
+
+    map_pointer other_node = other.curr_begin_node_;
+    for (map_pointer node = curr_begin_node_; node != curr_begin_node_ + nodes_cnt; ++node, ++other_node) {
+        size_type first_ind = (node == curr_begin_node_) ? other.begin_ind_ : 0;
+        size_type last_ind = (other_node == other.curr_end_node_) ? other.end_ind_ : buffer_size_;
+
+        *node = alloc_traits::allocate(alloc_, buffer_size_);
+        prefetch_node(*(other_node + deque_prefetch_distance), buffer_size_ * sizeof(value_type));
+        DEQUE_TRY {
+            construct_range(*node + first_ind, *other_node + first_ind, last_ind - first_ind);
+        } DEQUE_CATCH {
+            deallocate_node(node);
+            DEQUE_RETHROW;
         }
-    } catch (const std::exception& e) {
-        for (size_type j = 0; j < i; ++j) {
-            pop_back();
+        curr_end_node_ = node;
+        end_ind_ = last_ind;
+    }
+}
+
+template <typename T, typename Allocator>
+template <typename InputIt>
+InputIt deque<T, Allocator>::construct_range(pointer dest, InputIt first, size_type cnt) {
+    // constructs cnt elements on the raw memory [dest, dest + cnt), nothing stays constructed if an exception is thrown
+    if constexpr (bitwise_copyable_ && std::is_pointer_v<InputIt> &&
+                  std::is_same_v<std::remove_cvref_t<decltype(*first)>, value_type>) {
+        if (cnt != 0) {
+            std::memcpy(dest, first, cnt * sizeof(value_type));
         }
-        std::cerr << e.what() << '\n';
+        return first + cnt;
+    } else {
+        size_type i = 0;
+        DEQUE_TRY {
+            for (; i < cnt; ++i, ++first) {
+                alloc_traits::construct(alloc_, dest + i, *first);
+            }
+        } DEQUE_CATCH {
+            destroy_range(dest, dest + i);
+            DEQUE_RETHROW;
+        }
+        return first;
     }
 }
 
 template <typename T, typename Allocator>
-deque<T, Allocator>::deque(const deque& other)
-    : deque(other.begin(), other.end(), alloc_traits::select_on_container_copy_construction(other.alloc_),
-            pmap_alloc_traits::select_on_container_copy_construction(other.pmap_alloc_))
+template <typename... Args>
+void deque<T, Allocator>::fill_range(pointer dest, size_type cnt, const Args&... args) {
+    // constructs cnt elements from args on the raw memory [dest, dest + cnt), nothing stays constructed if an
+    // exception is thrown
+    if constexpr (sizeof...(Args) == 0 && zero_fillable_) {
+        std::memset(dest, 0, cnt * sizeof(value_type));
+    } else if constexpr (sizeof...(Args) == 1 && bitwise_copyable_) {
+        std::uninitialized_fill_n(dest, cnt, args...);
+    } else {
+        size_type i = 0;
+        DEQUE_TRY {
+            for (; i < cnt; ++i) {
+                alloc_traits::construct(alloc_, dest + i, args...);
+            }
+        } DEQUE_CATCH {
+            destroy_range(dest, dest + i);
+            DEQUE_RETHROW;
+        }
+    }
+}
+
+template <typename T, typename Allocator>
+template <typename InputIt>
+InputIt deque<T, Allocator>::append_n(InputIt first, size_type cnt) {
+    append_nodes(cnt, [this, &first](pointer dest, size_type node_cnt) {
+        first = construct_range(dest, first, node_cnt);
+    });
+    return first;
+}
+
+template <typename T, typename Allocator>
+template <typename Func>
+void deque<T, Allocator>::append_nodes(size_type cnt, Func&& construct) {
+    // construct(dest, node_cnt) is called for every contiguous chunk of the cnt new elements at the end,
+    // the pointers map is reallocated at most once
+    size_type free_in_node = buffer_size_ - end_ind_;
+    size_type new_nodes_cnt = cnt > free_in_node ? (cnt - free_in_node + buffer_size_ - 1) / buffer_size_ : 0;
+    if (static_cast<size_type>(finish_node_ - curr_end_node_ - 2) < new_nodes_cnt) {
+        reallocate_pointers_map(new_nodes_cnt);
+    }
+    while (cnt > 0) {
+        if (end_ind_ == buffer_size_) {
+            *(curr_end_node_ + 1) = alloc_traits::allocate(alloc_, buffer_size_);
+            ++curr_end_node_;
+            end_ind_ = 0;
+        }
+        size_type node_cnt = std::min(cnt, buffer_size_ - end_ind_);
+        DEQUE_TRY {
+            construct(*curr_end_node_ + end_ind_, node_cnt);
+        } DEQUE_CATCH {
+            if (end_ind_ == 0) {
+                deallocate_node(curr_end_node_);
+                --curr_end_node_;
+                end_ind_ = buffer_size_;
+            }
+            DEQUE_RETHROW;
+        }
+        end_ind_ += node_cnt;
+        cnt -= node_cnt;
+    }
+}
 
-{}
+template <typename T, typename Allocator>
+template <typename Func>
+void deque<T, Allocator>::prepend_nodes(size_type cnt, Func&& construct) {
+    // construct(dest, node_cnt) is called for every contiguous chunk of the cnt new elements at the beginning,
+    // starting from the last chunk, the pointers map is reallocated at most once
+    size_type new_nodes_cnt = cnt > begin_ind_ ? (cnt - begin_ind_ + buffer_size_ - 1) / buffer_size_ : 0;
+    if (static_cast<size_type>(curr_begin_node_ - start_node_) < new_nodes_cnt) {
+        reallocate_pointers_map(new_nodes_cnt);
+    }
+    while (cnt > 0) {
+        if (begin_ind_ == 0) {
+            *(curr_begin_node_ - 1) = alloc_traits::allocate(alloc_, buffer_size_);
+            --curr_begin_node_;
+            begin_ind_ = buffer_size_;
+        }
+        size_type node_cnt = std::min(cnt, begin_ind_);
+        DEQUE_TRY {
+            construct(*curr_begin_node_ + begin_ind_ - node_cnt, node_cnt);
+        } DEQUE_CATCH {
+            if (begin_ind_ == buffer_size_) {
+                deallocate_node(curr_begin_node_);
+                ++curr_begin_node_;
+                begin_ind_ = 0;
+            }
+            DEQUE_RETHROW;
+        }
+        begin_ind_ -= node_cnt;
+        cnt -= node_cnt;
+    }
+}
 
 template <typename T, typename Allocator>
-deque<T, Allocator>::deque(deque&& other)
+deque<T, Allocator>::deque(deque&& other) noexcept
     : alloc_(std::move_if_noexcept(other.alloc_)),
       pmap_alloc_(std::move_if_noexcept(other.pmap_alloc_)),
 
@@ -119,7 +304,10 @@ deque<T, Allocator>::deque(deque&& other)
       curr_end_node_(std::exchange(other.curr_end_node_, nullptr)),
       begin_ind_(std::exchange(other.begin_ind_, 0)),
       end_ind_(std::exchange(other.end_ind_, 0)),
-      buffer_size_(other.buffer_size_)
+      buffer_size_(other.buffer_size_),
+      max_buffer_size_(other.max_buffer_size_),
+      grown_back_(std::exchange(other.grown_back_, 0)),
+      grown_front_(std::exchange(other.grown_front_, 0))
 
 {
     other.default_constr_with_memory_cap(0);
@@ -129,14 +317,16 @@ deque<T, Allocator>::deque(deque&& other)
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::deque(const deque& other, const std::type_identity_t<Allocator>& alloc)
-    : deque(other.begin(), other.end(), alloc,
-            typename std::allocator_traits<std::type_identity_t<Allocator>>::rebind_alloc<PMapAlloc>()) {}
+    : deque(alloc, PMapAlloc(alloc)) {
+    copy_nodes(other);
+}
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::deque(deque&& other, const std::type_identity_t<Allocator>& alloc)
-    : alloc_(alloc),
-      pmap_alloc_(typename std::allocator_traits<std::type_identity_t<Allocator>>::rebind_alloc<PMapAlloc>()),
-      buffer_size_(other.buffer_size_) {
+    : deque(alloc, PMapAlloc(alloc)) {
+    adopt_block_size(other);
+    grown_back_ = std::exchange(other.grown_back_, 0);
+    grown_front_ = std::exchange(other.grown_front_, 0);
     if (other.get_allocator() == alloc_) {
         start_node_ = other.start_node_;
         finish_node_ = other.finish_node_;
@@ -144,31 +334,15 @@ deque<T, Allocator>::deque(deque&& other, const std::type_identity_t<Allocator>&
         curr_end_node_ = other.curr_end_node_;
         begin_ind_ = other.begin_ind_;
         end_ind_ = other.end_ind_;
-    } else {
-        size_type el_cnt = other.begin() - other.end();
-        size_type nodes_cnt = el_cnt / buffer_size_ + el_cnt % buffer_size_ + 2;
-
-        default_constr_with_memory_cap(nodes_cnt);
-        size_type i = 0;
-        try {
-            for (auto it = other.begin(); it != other.end(); ++i, ++it) {
-                emplace_back(std::move_if_noexcept(*it));
-            }
-        } catch (const std::exception& e) {
-            for (size_type j = 0; j < i; ++j) {
-                pop_back();
-            }
-            std::cerr << e.what() << '\n';
-        }
+        other.default_constr_with_memory_cap(0);
+        return;
     }
-
-    other.start_node_ = nullptr;
-    other.finish_node_ = nullptr;
-    other.curr_begin_node_ = nullptr;
-    other.curr_end_node_ = nullptr;
-    other.begin_ind_ = 0;
-    other.end_ind_ = 0;
-    other.default_constr_with_memory_cap(0);
+    // the nodes of other can't be released by alloc, so the elements are moved one by one
+    size_type el_cnt = other.size();
+    deallocate_map();
+    default_constr_with_memory_cap(el_cnt / buffer_size_ + (el_cnt % buffer_size_ == 0 ? 0 : 1));
+    append_n(std::make_move_iterator(other.begin()), el_cnt);
+    other.clear();
 }
 
 #endif
@@ -178,222 +352,217 @@ deque<T, Allocator>::deque(std::initializer_list<value_type> init, const Allocat
     : deque(init.begin(), init.end(), alloc) {}
 
 template <typename T, typename Allocator>
-template <typename Tp>
-deque<T, Allocator>::Iterator<Tp>::Iterator(el_pointer start, el_pointer curr, el_pointer finish, map_pointer curr_node)
-    : start_el_(start),
-      finish_el_(finish),
-      curr_el_(curr),
-      curr_node_(curr_node)
-
-{}
-
-template <typename T, typename Allocator>
-template <typename Tp>
-deque<T, Allocator>::Iterator<Tp>::Iterator(const Iterator& other)
-    : start_el_(other.start_el_),
-      finish_el_(other.finish_el_),
-      curr_el_(other.curr_el_),
-      curr_node_(other.curr_node_) {}
-
-template <typename T, typename Allocator>
-template <typename Tp>
-deque<T, Allocator>::Iterator<Tp> deque<T, Allocator>::Iterator<Tp>::operator=(const Iterator& other) {
-    start_el_ = other.start_el_;
-    finish_el_ = other.finish_el_;
-    curr_el_ = other.curr_el_;
-    curr_node_ = other.curr_node_;
-    return *this;
+deque<T, Allocator>::~deque() {
+    clear();
+    deallocate_map();
 }
 
 template <typename T, typename Allocator>
 template <typename Tp>
-deque<T, Allocator>::Iterator<Tp>::Iterator(Iterator&& other)
-    : start_el_(std::exchange(other.start_el_, nullptr)),
-      finish_el_(std::exchange(other.finish_el_, nullptr)),
-      curr_el_(std::exchange(other.curr_el_, nullptr)),
-      curr_node_(std::exchange(other.curr_node_, nullptr)) {}
+deque<T, Allocator>::Iterator<Tp>::Iterator(el_pointer start, el_pointer curr, el_pointer finish, map_pointer curr_node)
+    : curr_el_(curr), start_el_(start), finish_el_(finish), curr_node_(curr_node) {}
 
 template <typename T, typename Allocator>
 template <typename Tp>
 template <typename U>
 deque<T, Allocator>::Iterator<Tp>::Iterator(const Iterator<U>& other)
-    : start_el_(const_cast<el_pointer>(other.start_el_)),
-      curr_el_(const_cast<el_pointer>(other.curr_el_)),
+    : curr_el_(const_cast<el_pointer>(other.curr_el_)),
+      start_el_(const_cast<el_pointer>(other.start_el_)),
       finish_el_(const_cast<el_pointer>(other.finish_el_)),
       curr_node_(const_cast<map_pointer>(other.curr_node_)) {}
 
 template <typename T, typename Allocator>
 template <typename Tp>
-deque<T, Allocator>::Iterator<Tp> deque<T, Allocator>::Iterator<Tp>::operator=(Iterator&& other) {
-    start_el_ = std::exchange(other.start_el_, nullptr);
-    finish_el_ = std::exchange(other.finish_el_, nullptr);
-    curr_el_ = std::exchange(other.curr_el_, nullptr);
-    curr_node_ = std::exchange(other.curr_node_, nullptr);
-    return *this;
-}
-
-template <typename T, typename Allocator>
-deque<T, Allocator>::~deque() {
-    size_type front_cap = (curr_begin_node_ - start_node_) * buffer_size_ + begin_ind_;
-    size_type back_cap = (finish_node_ - curr_end_node_) * buffer_size_ + (buffer_size_ - end_ind_);
-    size_type mem_sz = size() + front_cap + back_cap;
-    clear();
-    pmap_alloc_traits::deallocate(pmap_alloc_, start_node_, mem_sz);
+void deque<T, Allocator>::Iterator<Tp>::set_node(map_pointer node, difference_type sz) {
+    curr_node_ = node;
+    start_el_ = *node;
+    if (start_el_ != nullptr) {
+        finish_el_ = start_el_ + sz;
+    } else {
+        finish_el_ = reinterpret_cast<el_pointer>(static_cast<std::uintptr_t>(sz));
+    }
 }
 
 template <typename T, typename Allocator>
 template <typename Tp>
-deque<T, Allocator>::Iterator<Tp>::reference deque<T, Allocator>::Iterator<Tp>::Iterator::operator++() {
-    ++curr_el_;
-    if (curr_el_ == finish_el_) {
-        auto sz = finish_el_ - start_el_;
-        ++curr_node_;
-        start_el_ = curr_el_ = *curr_node_;
-        finish_el_ = start_el_ + sz;
+deque<T, Allocator>::Iterator<Tp>::difference_type deque<T, Allocator>::Iterator<Tp>::node_size() const {
+    if (start_el_ != nullptr) {
+        return finish_el_ - start_el_;
     }
-    return *curr_el_;
+    return static_cast<difference_type>(reinterpret_cast<std::uintptr_t>(finish_el_));
 }
 
 template <typename T, typename Allocator>
 template <typename Tp>
-deque<T, Allocator>::Iterator<Tp>::value_type deque<T, Allocator>::Iterator<Tp>::Iterator::operator++(int) {
-    auto tmp_copy = *curr_el_;
-    ++curr_el_;
-    if (curr_el_ == finish_el_) {
-        auto sz = finish_el_ - start_el_;
-        ++curr_node_;
-        start_el_ = curr_el_ = *curr_node_;
-        finish_el_ = start_el_ + sz;
+deque<T, Allocator>::Iterator<Tp>& deque<T, Allocator>::Iterator<Tp>::operator++() {
+    if (++curr_el_ == finish_el_) {
+        set_node(curr_node_ + 1, finish_el_ - start_el_);
+        curr_el_ = start_el_;
+        if constexpr (deque_prefetch_iterators) {
+            prefetch_node(*(curr_node_ + deque_prefetch_distance), node_size() * sizeof(Tp));
+        }
     }
-    return tmp_copy;
+    return *this;
 }
 
 template <typename T, typename Allocator>
 template <typename Tp>
-deque<T, Allocator>::Iterator<Tp>::reference deque<T, Allocator>::Iterator<Tp>::Iterator::operator--() {
-    if (curr_el_ == start_el_) {
-        auto sz = finish_el_ - start_el_;
-        --curr_node_;
-        start_el_ = *curr_node_;
-        finish_el_ = *curr_node_ + sz;
-        curr_el_ = *curr_node_ + sz - 1;
-    } else {
-        --curr_el_;
-    }
-    return *curr_el_;
+deque<T, Allocator>::Iterator<Tp> deque<T, Allocator>::Iterator<Tp>::operator++(int) {
+    Iterator tmp = *this;
+    ++*this;
+    return tmp;
 }
 
 template <typename T, typename Allocator>
 template <typename Tp>
-deque<T, Allocator>::Iterator<Tp>::value_type deque<T, Allocator>::Iterator<Tp>::Iterator::operator--(int) {
-    auto tmp_copy = *curr_el_;
+deque<T, Allocator>::Iterator<Tp>& deque<T, Allocator>::Iterator<Tp>::operator--() {
     if (curr_el_ == start_el_) {
-        auto sz = finish_el_ - start_el_;
-        --curr_node_;
-        start_el_ = *curr_node_;
-        finish_el_ = *curr_node_ + sz;
-        curr_el_ = *curr_node_ + sz - 1;
-    } else {
-        --curr_el_;
+        set_node(curr_node_ - 1, node_size());
+        curr_el_ = finish_el_;
+        if constexpr (deque_prefetch_iterators) {
+            prefetch_node(*(curr_node_ - deque_prefetch_distance), node_size() * sizeof(Tp));
+        }
     }
-    return tmp_copy;
+    --curr_el_;
+    return *this;
 }
 
 template <typename T, typename Allocator>
 template <typename Tp>
-deque<T, Allocator>::Iterator<Tp>::reference deque<T, Allocator>::Iterator<Tp>::Iterator::operator*() {
-    return *curr_el_;
+deque<T, Allocator>::Iterator<Tp> deque<T, Allocator>::Iterator<Tp>::operator--(int) {
+    Iterator tmp = *this;
+    --*this;
+    return tmp;
 }
 
 template <typename T, typename Allocator>
 template <typename Tp>
-deque<T, Allocator>::Iterator<Tp>::const_reference deque<T, Allocator>::Iterator<Tp>::Iterator::operator*() const {
+deque<T, Allocator>::Iterator<Tp>::reference deque<T, Allocator>::Iterator<Tp>::operator*() const {
     return *curr_el_;
 }
 
 template <typename T, typename Allocator>
 template <typename Tp>
-deque<T, Allocator>::Iterator<Tp>::pointer deque<T, Allocator>::Iterator<Tp>::Iterator::operator->() {
+deque<T, Allocator>::Iterator<Tp>::pointer deque<T, Allocator>::Iterator<Tp>::operator->() const {
     return curr_el_;
 }
 
 template <typename T, typename Allocator>
 template <typename Tp>
-deque<T, Allocator>::Iterator<Tp>::const_pointer deque<T, Allocator>::Iterator<Tp>::Iterator::operator->() const {
-    return curr_el_;
+deque<T, Allocator>::Iterator<Tp>::reference deque<T, Allocator>::Iterator<Tp>::operator[](difference_type n) const {
+    return *(*this + n);
 }
 
 template <typename T, typename Allocator>
 template <typename Tp>
-deque<T, Allocator>::Iterator<Tp> deque<T, Allocator>::Iterator<Tp>::Iterator::operator+(difference_type n) {
-    difference_type fc_diff = finish_el_ - curr_el_;
-    Iterator ret_it = *this;
-    if (fc_diff > n) {
-        ret_it.curr_el_ += n;
-        return ret_it;
-    }
-    size_type sz = ret_it.finish_el_ - ret_it.start_el_;
-    if (sz == 0) {
-        throw std::runtime_error("Invalid iterator finish-start borders");
+deque<T, Allocator>::Iterator<Tp>& deque<T, Allocator>::Iterator<Tp>::operator+=(difference_type n) {
+    difference_type sz = node_size();
+    difference_type offset = n + (curr_el_ - start_el_);
+    if (offset >= 0 && offset < sz) {
+        curr_el_ += n;
+    } else {
+        // floor division, so that a negative offset moves to the previous nodes
+        difference_type node_offset = offset > 0 ? offset / sz : -((-offset - 1) / sz) - 1;
+        set_node(curr_node_ + node_offset, sz);
+        curr_el_ = start_el_ + (offset - node_offset * sz);
     }
-    n -= fc_diff;
-    ++(ret_it.curr_node_);
-
-    ret_it.curr_node_ += n / sz;
+    return *this;
+}
 
-    ret_it.start_el_ = *(ret_it.curr_node_);
-    ret_it.curr_el_ = ret_it.start_el_ + n % sz;
-    ret_it.finish_el_ = ret_it.start_el_ + sz;
+template <typename T, typename Allocator>
+template <typename Tp>
+deque<T, Allocator>::Iterator<Tp>& deque<T, Allocator>::Iterator<Tp>::operator-=(difference_type n) {
+    return *this += -n;
+}
 
-    return *this;
+template <typename T, typename Allocator>
+template <typename Tp>
+deque<T, Allocator>::Iterator<Tp> deque<T, Allocator>::Iterator<Tp>::operator+(difference_type n) const {
+    Iterator ret_it = *this;
+    return ret_it += n;
 }
 
 template <typename T, typename Allocator>
 template <typename Tp>
-deque<T, Allocator>::Iterator<Tp> deque<T, Allocator>::Iterator<Tp>::Iterator::operator-(difference_type n) {
-    difference_type cs_diff = curr_el_ - start_el_;
+deque<T, Allocator>::Iterator<Tp> deque<T, Allocator>::Iterator<Tp>::operator-(difference_type n) const {
     Iterator ret_it = *this;
-    if (cs_diff >= n) {
-        ret_it.curr_el_ -= n;
-        return ret_it;
-    }
-    size_type sz = ret_it.finish_el_ - ret_it.start_el_;
-    if (sz == 0) {
-        throw std::runtime_error("Invalid iterator finish-start borders");
-    }
-    n -= cs_diff + 1;
-    --(ret_it.curr_node_);
-    ret_it.curr_node_ -= n / sz;
-    ret_it.start_el_ = *(ret_it.curr_node_);
-    ret_it.finish_el_ = ret_it.start_el_ + sz;
-    ret_it.curr_el_ = ret_it.finish_el_ - 1 - n % sz;
-    return ret_it;
+    return ret_it += -n;
 }
 
 template <typename T, typename Allocator>
 template <typename Tp>
 template <typename U>
-deque<T, Allocator>::Iterator<Tp>::difference_type deque<T, Allocator>::Iterator<Tp>::Iterator::operator-(
+deque<T, Allocator>::Iterator<Tp>::difference_type deque<T, Allocator>::Iterator<Tp>::operator-(
     const Iterator<U>& it) const {
-    if (curr_node_ == it.curr_node_) {
-        return curr_el_ - it.curr_el_;
-    }
-    difference_type full_nodes = curr_node_ - const_cast<map_pointer>(it.curr_node_) - 1;
-    size_type sz = finish_el_ - start_el_;
-    return full_nodes * sz + (curr_el_ - start_el_) + (it.finish_el_ - it.curr_el_);
+    return node_size() * (curr_node_ - const_cast<map_pointer>(it.curr_node_)) + (curr_el_ - start_el_) -
+           (it.curr_el_ - it.start_el_);
 }
 
 template <typename T, typename Allocator>
 template <typename Tp>
-bool deque<T, Allocator>::Iterator<Tp>::Iterator::operator==(const Iterator& other) const {
-    return start_el_ == other.start_el_ && curr_el_ == other.curr_el_ && finish_el_ == other.finish_el_ &&
-           curr_node_ == other.curr_node_;
+bool deque<T, Allocator>::Iterator<Tp>::operator==(const Iterator& other) const {
+    // every position has a single representation: the beginning of a node is never stored as the end of the
+    // previous one
+    return curr_el_ == other.curr_el_;
 }
 
 template <typename T, typename Allocator>
 template <typename Tp>
-bool deque<T, Allocator>::Iterator<Tp>::Iterator::operator!=(const Iterator& other) const {
-    return !(*this == other);
+std::strong_ordering deque<T, Allocator>::Iterator<Tp>::operator<=>(const Iterator& other) const {
+    if (curr_node_ != other.curr_node_) {
+        return curr_node_ <=> other.curr_node_;
+    }
+    return curr_el_ <=> other.curr_el_;
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::segment_view::segment_view(pointer* node, size_type ind, size_type count, size_type buffer_size)
+    : node_(node), ind_(ind), count_(count), buffer_size_(buffer_size) {}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::segment_view::iterator deque<T, Allocator>::segment_view::begin() const {
+    return iterator(node_, ind_, count_, buffer_size_);
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::segment_view::iterator deque<T, Allocator>::segment_view::end() const {
+    return iterator();
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::size_type deque<T, Allocator>::segment_view::size() const {
+    return count_;
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::segment_view::iterator::iterator(pointer* node, size_type ind, size_type left,
+                                                      size_type buffer_size)
+    : node_(node), ind_(ind), left_(left), buffer_size_(buffer_size) {}
+
+template <typename T, typename Allocator>
+std::span<T> deque<T, Allocator>::segment_view::iterator::operator*() const {
+    return std::span<T>(*node_ + ind_, std::min(left_, buffer_size_ - ind_));
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::segment_view::iterator& deque<T, Allocator>::segment_view::iterator::operator++() {
+    left_ -= std::min(left_, buffer_size_ - ind_);
+    ++node_;
+    ind_ = 0;
+    return *this;
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::segment_view::iterator deque<T, Allocator>::segment_view::iterator::operator++(int) {
+    iterator tmp = *this;
+    ++*this;
+    return tmp;
+}
+
+template <typename T, typename Allocator>
+bool deque<T, Allocator>::segment_view::iterator::operator==(const iterator& other) const {
+    // all exhausted iterators are equal to end()
+    return left_ == other.left_ && (left_ == 0 || (node_ == other.node_ && ind_ == other.ind_));
 }
 
 template <typename T, typename Allocator>
@@ -416,71 +585,76 @@ deque<T, Allocator>::const_reference deque<T, Allocator>::back() const {
     return *(*curr_end_node_ + end_ind_ - 1);
 }
 
+template <typename T, typename Allocator>
+deque<T, Allocator>::iterator deque<T, Allocator>::make_iterator(map_pointer node, size_type ind) const {
+    if (ind == buffer_size_) {  // the position right after a full node is the beginning of the next one
+        ++node;
+        ind = 0;
+    }
+    iterator it;
+    it.set_node(node, buffer_size_);
+    it.curr_el_ = it.start_el_ + ind;  // ind is 0 on an unallocated node
+    return it;
+}
+
 template <typename T, typename Allocator>
 deque<T, Allocator>::iterator deque<T, Allocator>::begin() {
-    return iterator(*curr_begin_node_, *curr_begin_node_ + begin_ind_, *curr_begin_node_ + buffer_size_,
-                    curr_begin_node_);
+    return make_iterator(curr_begin_node_, begin_ind_);
 }
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::const_iterator deque<T, Allocator>::begin() const {
-    return const_iterator(const_cast<const T*>(*curr_begin_node_), const_cast<const T*>(*curr_begin_node_ + begin_ind_),
-                          const_cast<const T*>(*curr_begin_node_ + buffer_size_),
-                          const_cast<const T**>(curr_begin_node_));
+    return make_iterator(curr_begin_node_, begin_ind_);
 }
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::const_iterator deque<T, Allocator>::cbegin() const noexcept {
-    return const_iterator(const_cast<const T*>(*curr_begin_node_), const_cast<const T*>(*curr_begin_node_ + begin_ind_),
-                          const_cast<const T*>(*curr_begin_node_ + buffer_size_),
-                          const_cast<const T**>(curr_begin_node_));
+    return make_iterator(curr_begin_node_, begin_ind_);
 }
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::iterator deque<T, Allocator>::end() {
-    return iterator(*curr_end_node_, *curr_end_node_ + end_ind_, *curr_end_node_ + buffer_size_, curr_end_node_);
+    return make_iterator(curr_end_node_, end_ind_);
 }
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::const_iterator deque<T, Allocator>::end() const {
-    return const_iterator(const_cast<const T*>(*curr_end_node_), const_cast<const T*>(*curr_end_node_ + end_ind_),
-                          const_cast<const T*>(*curr_end_node_ + buffer_size_), const_cast<const T**>(curr_end_node_));
+    return make_iterator(curr_end_node_, end_ind_);
 }
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::const_iterator deque<T, Allocator>::cend() const noexcept {
-    return const_iterator(const_cast<const T*>(*curr_end_node_), const_cast<const T*>(*curr_end_node_ + end_ind_),
-                          const_cast<const T*>(*curr_end_node_ + buffer_size_), const_cast<const T**>(curr_end_node_));
+    return make_iterator(curr_end_node_, end_ind_);
 }
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::reverse_iterator deque<T, Allocator>::rbegin() {
-    return end();
+    return reverse_iterator(end());
 }
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::const_reverse_iterator deque<T, Allocator>::rbegin() const {
-    return end();
+    return const_reverse_iterator(end());
 }
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::const_reverse_iterator deque<T, Allocator>::crbegin() const noexcept {
-    return cend();
+    return const_reverse_iterator(cend());
 }
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::reverse_iterator deque<T, Allocator>::rend() {
-    return begin();
+    return reverse_iterator(begin());
 }
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::const_reverse_iterator deque<T, Allocator>::rend() const {
-    return begin();
+    return const_reverse_iterator(begin());
 }
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::const_reverse_iterator deque<T, Allocator>::crend() const noexcept {
-    return cbegin();
+    return const_reverse_iterator(cbegin());
 }
 
 template <typename T, typename Allocator>
@@ -488,32 +662,77 @@ size_t deque<T, Allocator>::deque_buffer_sz(size_t sz) {
     return (sz > deque_buffer_size) ? size_t(1) : (deque_buffer_size / sz);
 }
 
+template <typename T, typename Allocator>
+inline void deque<T, Allocator>::prefetch_node(const void* block, size_type bytes) {
+    // the blocks are separate allocations, so the hardware prefetcher doesn't follow a scan from one to the next
+#if defined(__GNUC__) || defined(__clang__)
+    if constexpr (deque_prefetch_distance != 0) {
+        if (block != nullptr) {
+            const char* first = static_cast<const char*>(block);
+            for (size_type offset = 0; offset < std::min(bytes, deque_buffer_size); offset += 64) {
+                __builtin_prefetch(first + offset);
+            }
+        }
+    }
+#endif
+}
+
 template <typename T, typename Allocator>
 void deque<T, Allocator>::reallocate_pointers_map(size_type offset_borders) {
-    size_type sz = size();
+    // offset_borders free nodes are left on each side of the data, plus one node after curr_end_node_
+    // that end() may point to
+    size_type nodes_cnt = curr_end_node_ - curr_begin_node_ + 1;
     if (offset_borders == 0) {
-        offset_borders = sz / 2 + sz % 2;
-    }
-    auto new_start = pmap_alloc_traits::allocate(pmap_alloc_, sz + 2 * offset_borders);
-    auto new_begin = new_start + offset_borders;
-    auto node = new_begin;
-    auto new_node = new_begin;
-    try {
-        for (; node != curr_end_node_; ++node, ++new_node) {
-            pmap_alloc_traits::construct(pmap_alloc_, new_node, *node);
-        }
-    } catch (const std::exception& e) {
-        for (; node != new_begin - 1; --node, --new_node) {
-            pmap_alloc_traits::destroy(pmap_alloc_, new_node);
-        }
+        offset_borders = nodes_cnt / 2 + 1;
     }
+    size_type new_cap = nodes_cnt + 2 * offset_borders + 1;
+    map_pointer new_start = allocate_map(new_cap);
+    map_pointer new_begin = new_start + offset_borders;
+    std::copy(curr_begin_node_, curr_end_node_ + 1, new_begin);
 
-    pmap_alloc_traits::deallocate(pmap_alloc_, start_node_, finish_node_ - start_node_);
+    deallocate_map();
 
-    curr_begin_node_ = new_begin;
-    curr_end_node_ = curr_begin_node_ + sz;
-    finish_node_ = new_start + sz + 2 * offset_borders;
     start_node_ = new_start;
+    finish_node_ = new_start + new_cap;
+    curr_begin_node_ = new_begin;
+    curr_end_node_ = new_begin + nodes_cnt - 1;
+}
+
+template <typename T, typename Allocator>
+void deque<T, Allocator>::adopt_block_size(const deque& other) {
+    buffer_size_ = other.buffer_size_;
+    max_buffer_size_ = other.max_buffer_size_;
+    end_ind_ = buffer_size_;
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::size_type deque<T, Allocator>::grown_buffer_size(size_type extra) const {
+    size_type new_buffer_size = buffer_size_;
+    if (new_buffer_size == max_buffer_size_) {
+        return new_buffer_size;
+    }
+    size_type target = size() + extra;
+    while (new_buffer_size < max_buffer_size_ && target > new_buffer_size * deque_blocks_before_growth) {
+        new_buffer_size = std::min(new_buffer_size * 2, max_buffer_size_);
+    }
+    return new_buffer_size;
+}
+
+template <typename T, typename Allocator>
+void deque<T, Allocator>::reblock(size_type new_buffer_size) {
+    // the elements are copied if moving may throw, so that the deque is unchanged on an exception
+    size_type cnt = size();
+    deque<T, Allocator> tmp_deque(alloc_, pmap_alloc_);
+    tmp_deque.adopt_block_size(*this);
+    tmp_deque.buffer_size_ = new_buffer_size;
+    tmp_deque.end_ind_ = new_buffer_size;
+    tmp_deque.default_constr_with_memory_cap(cnt / new_buffer_size + 1);
+    if constexpr (std::is_nothrow_move_constructible_v<value_type> || !std::is_copy_constructible_v<value_type>) {
+        tmp_deque.append_n(std::make_move_iterator(begin()), cnt);
+    } else {
+        tmp_deque.append_n(begin(), cnt);
+    }
+    swap(tmp_deque);
 }
 
 template <typename T, typename Allocator>
@@ -529,23 +748,34 @@ void deque<T, Allocator>::push_back(deque<T, Allocator>::value_type&& value) {
 template <typename T, typename Allocator>
 template <class... Args>
 deque<T, Allocator>::reference deque<T, Allocator>::emplace_back(Args&&... args) {
-    if (curr_end_node_ == finish_node_ && end_ind_ == buffer_size_) {  // reallocate pointers map
+    if (end_ind_ == buffer_size_ && grown_buffer_size(1) != buffer_size_) {
+        // the new element is created first, args may refer to an element that reblock moves
+        value_type value(std::forward<Args>(args)...);
+        reblock(grown_buffer_size(1));
+        return emplace_back(std::move(value));
+    }
+    if (finish_node_ - curr_end_node_ <= 2 && end_ind_ == buffer_size_) {  // reallocate pointers map
         reallocate_pointers_map();
     }
     if (end_ind_ == buffer_size_) {
-        auto val = alloc_traits::allocate(alloc_, buffer_size_);
-        try {
-            pmap_alloc_traits::construct(pmap_alloc_, curr_end_node_ + 1, val);
-        } catch (const std::exception& e) {
-            alloc_traits::deallocate(alloc_, val, buffer_size_);
-            throw e;
+        // the element is constructed before the node is linked, so a throwing constructor changes nothing
+        pointer block = alloc_traits::allocate(alloc_, buffer_size_);
+        if constexpr (std::is_nothrow_constructible_v<value_type, Args&&...>) {
+            alloc_traits::construct(alloc_, block, std::forward<Args>(args)...);
+        } else {
+            DEQUE_TRY {
+                alloc_traits::construct(alloc_, block, std::forward<Args>(args)...);
+            } DEQUE_CATCH {
+                alloc_traits::deallocate(alloc_, block, buffer_size_);
+                DEQUE_RETHROW;
+            }
         }
-        end_ind_ = 0;
-        ++curr_end_node_;
+        *++curr_end_node_ = block;
+        end_ind_ = 1;
+        return *block;
     }
     alloc_traits::construct(alloc_, *curr_end_node_ + end_ind_, std::forward<Args>(args)...);
-    ++end_ind_;
-    return *(*curr_end_node_ + end_ind_ - 1);
+    return *(*curr_end_node_ + end_ind_++);
 }
 
 template <typename T, typename Allocator>
@@ -561,24 +791,32 @@ void deque<T, Allocator>::push_front(deque<T, Allocator>::value_type&& value) {
 template <typename T, typename Allocator>
 template <class... Args>
 deque<T, Allocator>::reference deque<T, Allocator>::emplace_front(Args&&... args) {
+    if (begin_ind_ == 0 && grown_buffer_size(1) != buffer_size_) {
+        value_type value(std::forward<Args>(args)...);
+        reblock(grown_buffer_size(1));
+        return emplace_front(std::move(value));
+    }
     if (curr_begin_node_ == start_node_ && begin_ind_ == 0) {  // reallocate pointers map
         reallocate_pointers_map();
     }
     if (begin_ind_ == 0) {
-        auto val = alloc_traits::allocate(alloc_, buffer_size_);
-        try {
-            pmap_alloc_traits::construct(pmap_alloc_, curr_begin_node_ - 1, val);
-        } catch (const std::exception& e) {
-            alloc_traits::deallocate(alloc_, val, buffer_size_);
-            throw e;
+        pointer block = alloc_traits::allocate(alloc_, buffer_size_);
+        if constexpr (std::is_nothrow_constructible_v<value_type, Args&&...>) {
+            alloc_traits::construct(alloc_, block + buffer_size_ - 1, std::forward<Args>(args)...);
+        } else {
+            DEQUE_TRY {
+                alloc_traits::construct(alloc_, block + buffer_size_ - 1, std::forward<Args>(args)...);
+            } DEQUE_CATCH {
+                alloc_traits::deallocate(alloc_, block, buffer_size_);
+                DEQUE_RETHROW;
+            }
         }
-
-        begin_ind_ = buffer_size_;
-        --curr_begin_node_;
+        *--curr_begin_node_ = block;
+        begin_ind_ = buffer_size_ - 1;
+        return *(block + begin_ind_);
     }
-    --begin_ind_;
-    alloc_traits::construct(alloc_, *curr_begin_node_ + begin_ind_, std::forward<Args>(args)...);
-    return *(*curr_begin_node_ + begin_ind_);
+    alloc_traits::construct(alloc_, *curr_begin_node_ + begin_ind_ - 1, std::forward<Args>(args)...);
+    return *(*curr_begin_node_ + --begin_ind_);
 }
 
 template <typename T, typename Allocator>
@@ -597,8 +835,19 @@ deque<T, Allocator>::size_type deque<T, Allocator>::size() const {
     return end() - begin();
 }
 
+template <typename T, typename Allocator>
+deque<T, Allocator>::size_type deque<T, Allocator>::block_size() const {
+    return buffer_size_;
+}
+
 template <typename T, typename Allocator>
 void deque<T, Allocator>::shrink_to_fit() {
+    if (empty()) {  // gives the map back and returns to the shared empty map
+        clear();
+        deallocate_map();
+        default_constr_with_memory_cap(0);
+        return;
+    }
     difference_type front_cap = (curr_begin_node_ - start_node_) * buffer_size_ + begin_ind_;
     difference_type back_cap = (finish_node_ - curr_end_node_) * buffer_size_ + (buffer_size_ - end_ind_);
     if ((front_cap + back_cap) < buffer_size_) {
@@ -609,137 +858,146 @@ void deque<T, Allocator>::shrink_to_fit() {
 
 template <typename T, typename Allocator>
 void deque<T, Allocator>::shrink_to_fit_nodes() {
-    size_type new_nodes_cnt = size() / buffer_size_ + (size() % buffer_size_ == 0 ? 0 : 1);
-    map_pointer new_start = pmap_alloc_traits::allocate(pmap_alloc_, new_nodes_cnt);
-    size_type i;
-    try {
-        // выделение памяти для каждой ноды
-        for (i = 0; i < new_nodes_cnt; ++i) {
-            auto chunk = alloc_traits::allocate(alloc_, buffer_size_);
-            pmap_alloc_traits::construct(pmap_alloc_, new_start + i, chunk);
+    // moves the elements to the beginning of new nodes in a map without free nodes, plus the one end() may point to
+    size_type sz = size();
+    size_type new_nodes_cnt = (sz + buffer_size_ - 1) / buffer_size_;
+    map_pointer new_start = allocate_map(new_nodes_cnt + 1);
+    size_type i = 0;
+    DEQUE_TRY {
+        for (; i < new_nodes_cnt; ++i) {
+            *(new_start + i) = alloc_traits::allocate(alloc_, buffer_size_);
         }
-
-        move_nodes(new_start, 0, curr_begin_node_, begin_ind_, new_nodes_cnt);
-
-    } catch (const std::exception& e) {
+        move_nodes(new_start, 0, curr_begin_node_, begin_ind_, sz);
+    } DEQUE_CATCH {
         for (size_type j = 0; j < i; ++j) {
-            alloc_traits::deallocate(alloc_, *(new_start + i), buffer_size_);
-            pmap_alloc_traits::destroy(pmap_alloc_, new_start + i);
+            alloc_traits::deallocate(alloc_, *(new_start + j), buffer_size_);
         }
-        std::cerr << e.what() << '\n';
+        deallocate_map(new_start, new_start + new_nodes_cnt + 1);
+        DEQUE_RETHROW;
     }
+    clear();
+    deallocate_map();
+    start_node_ = new_start;
+    finish_node_ = new_start + new_nodes_cnt + 1;
+    curr_begin_node_ = new_start;
+    curr_end_node_ = new_start + new_nodes_cnt - 1;
+    begin_ind_ = 0;
+    end_ind_ = sz - (new_nodes_cnt - 1) * buffer_size_;
 }
 
 template <typename T, typename Allocator>
 void deque<T, Allocator>::move_nodes(map_pointer new_begin, size_type new_begin_ind, map_pointer old_begin,
                                      size_type old_begin_ind, size_type cnt) {
-    // функция мувает cnt элементов с ноды old_begin с индекса old_begin_ind в ноду new_begin с индекса new_begin_ind
-    // память в *new_begin и далее (cnt ячекк) должна быть только саллоцированной (сырой)
+    // the elements are copied if moving may throw, the old ones stay as they were then
     map_pointer new_node = new_begin;
     map_pointer old_node = old_begin;
-
-    size_type new_ind = old_begin_ind % buffer_size_;
-    size_type old_ind = old_begin_ind % buffer_size_;
-
-    size_type i;
-
-    try {
-        for (i = 0; i < cnt; ++i) {
-            alloc_traits::construct(alloc_, *new_node + new_ind, std::move(*(*old_node) + old_ind));
-
-            if (++new_ind == buffer_size_) {
+    size_type new_ind = new_begin_ind;
+    size_type old_ind = old_begin_ind;
+    size_type done = 0;
+    auto move_all = [&]() {
+        for (size_type left = cnt; left > 0;) {
+            size_type chunk = std::min({left, buffer_size_ - new_ind, buffer_size_ - old_ind});
+            if constexpr (bitwise_copyable_) {
+                std::memcpy(*new_node + new_ind, *old_node + old_ind, chunk * sizeof(value_type));
+                done += chunk;
+            } else {
+                for (size_type i = 0; i < chunk; ++i, ++done) {
+                    alloc_traits::construct(alloc_, *new_node + new_ind + i,
+                                            std::move_if_noexcept(*(*old_node + old_ind + i)));
+                }
+            }
+            left -= chunk;
+            if ((new_ind += chunk) == buffer_size_) {
                 new_ind = 0;
                 ++new_node;
             }
-            if (++old_ind == buffer_size_) {
+            if ((old_ind += chunk) == buffer_size_) {
                 old_ind = 0;
                 ++old_node;
             }
         }
-
-    } catch (const std::exception& e) {
-        for (size_type j = 0; j < i; ++j) {
-            if constexpr (std::is_nothrow_move_constructible_v<value_type>) {  // значение мувалось без исключений,
-                                                                               // исключение вызвано методом construct
-                if (std::is_nothrow_move_assignable_v<value_type>) {
-                    *(*old_node + old_ind) = std::move(*(*new_node + new_ind));
+    };
+    if constexpr (std::is_nothrow_move_constructible_v<value_type> || !std::is_copy_constructible_v<value_type>) {
+        move_all();
+    } else {
+        DEQUE_TRY {
+            move_all();
+        } DEQUE_CATCH {
+            // destroys the copies made so far
+            map_pointer node = new_begin;
+            size_type ind = new_begin_ind;
+            for (; done > 0; --done) {
+                alloc_traits::destroy(alloc_, *node + ind);
+                if (++ind == buffer_size_) {
+                    ind = 0;
+                    ++node;
                 }
             }
-            alloc_traits::destroy(alloc_, *new_node + new_ind);
-
-            if (new_ind == 0) {
-                new_ind = buffer_size_;
-                --new_node;
-            }
-            if (old_ind == 0) {
-                old_ind = buffer_size_;
-                --old_node;
-            }
-            --new_ind;
-            --old_ind;
+            DEQUE_RETHROW;
         }
+    }
+}
 
-        throw e;
+template <typename T, typename Allocator>
+void deque<T, Allocator>::destroy_range(pointer first, pointer last) {
+    if constexpr (!std::is_trivially_destructible_v<value_type>) {
+        for (; first != last; ++first) {
+            alloc_traits::destroy(alloc_, first);
+        }
     }
 }
 
 template <typename T, typename Allocator>
 void deque<T, Allocator>::destroy_node(map_pointer node, size_type first_ind, size_type last_ind) {
-    if (first_ind == last_ind) return;
-    for (size_type i = first_ind; i != last_ind; ++i) {
-        alloc_traits::destroy(alloc_, *node + i);
-    }
-    alloc_traits::deallocate(alloc_, *node, last_ind - first_ind);
-    pmap_alloc_traits::destroy(pmap_alloc_, node);
+    destroy_range(*node + first_ind, *node + last_ind);
+    deallocate_node(node);
+}
+
+template <typename T, typename Allocator>
+void deque<T, Allocator>::deallocate_node(map_pointer node) {
+    alloc_traits::deallocate(alloc_, *node, buffer_size_);
+    *node = nullptr;
 }
 
 template <typename T, typename Allocator>
 void deque<T, Allocator>::clear() {
-    if (empty()) return;
     if (curr_begin_node_ == curr_end_node_) {
         destroy_node(curr_begin_node_, begin_ind_, end_ind_);
-        return;
-    }
-    destroy_node(curr_begin_node_, begin_ind_, buffer_size_);
-    destroy_node(curr_end_node_, 0, end_ind_);
-
-    for (map_pointer p = curr_begin_node_ + 1; p != curr_end_node_; ++p) {
-        destroy_node(p, 0, buffer_size_);
+    } else if (curr_begin_node_ < curr_end_node_) {
+        destroy_node(curr_begin_node_, begin_ind_, buffer_size_);
+        for (map_pointer p = curr_begin_node_ + 1; p != curr_end_node_; ++p) {
+            destroy_node(p, 0, buffer_size_);
+        }
+        destroy_node(curr_end_node_, 0, end_ind_);
     }
-    curr_begin_node_ = start_node_;
-    curr_end_node_ = start_node_;
-    begin_ind_ = end_ind_ = 0;
+    curr_begin_node_ = start_node_ + (finish_node_ - start_node_) / 2;
+    curr_end_node_ = curr_begin_node_ - 1;
+    begin_ind_ = 0;
+    end_ind_ = buffer_size_;
+    grown_back_ = 0;
+    grown_front_ = 0;
 }
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::iterator deque<T, Allocator>::insert(const_iterator pos, const T& value) {
-    if (pos == begin()) {
-        emplace_front(value);
-        return begin();
-    }
-    size_type front_diff = pos - begin();
-    size_type back_diff = end() - pos;
-    auto func = [&value]() { return value; };
-    if (front_diff > back_diff) {
-        return insert_front(pos, 1, std::ref(func));
+    size_type front_diff = pos - cbegin();
+    size_type back_diff = cend() - pos;
+    auto func = [&value]() -> const value_type& { return value; };
+    if (front_diff < back_diff) {
+        return insert_front(pos, 1, func);
     }
-    return insert_back(pos, 1, std::ref(func));
+    return insert_back(pos, 1, func);
 }
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::iterator deque<T, Allocator>::insert(const_iterator pos, T&& value) {
-    if (pos == begin()) {
-        emplace_front(std::move(value));
-        return begin();
-    }
-    size_type front_diff = pos - begin();
-    size_type back_diff = end() - pos;
-
-    auto func = [&value]() mutable -> value_type&& { return std::move(value); };
-    if (front_diff > back_diff) {
-        return insert_front(pos, 1, std::ref(func));
+    size_type front_diff = pos - cbegin();
+    size_type back_diff = cend() - pos;
+    auto func = [&value]() -> value_type&& { return std::move(value); };
+    if (front_diff < back_diff) {
+        return insert_front(pos, 1, func);
     }
-    return insert_back(pos, 1, std::ref(func));
+    return insert_back(pos, 1, func);
 }
 
 template <typename T, typename Allocator>
@@ -750,54 +1008,37 @@ deque<T, Allocator>::iterator deque<T, Allocator>::emplace(const_iterator pos, A
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::iterator deque<T, Allocator>::insert(const_iterator pos, size_type count, const T& value) {
-    size_type front_diff = pos - begin();
-    size_type back_diff = end() - pos;
-    auto func = [&value]() { return value; };
+    size_type front_diff = pos - cbegin();
+    size_type back_diff = cend() - pos;
+    auto func = [&value]() -> const value_type& { return value; };
     if (front_diff < back_diff) {
-        return insert_front(pos, count, std::ref(func));
+        return insert_front(pos, count, func);
     }
-    return insert_back(pos, count, std::ref(func));
+    return insert_back(pos, count, func);
 }
 
 template <typename T, typename Allocator>
 template <class InputIt>
 deque<T, Allocator>::iterator deque<T, Allocator>::insert(const_iterator pos, InputIt first, InputIt last) {
-    size_type front_diff = pos - begin();
-    size_type back_diff = end() - pos;
-
-    deque<T, Allocator>::iterator ret_val;
-    auto func = [first]() { return *first; };
-    if (front_diff < back_diff) {
-        for (; first != last; ++first) {
-            ret_val = insert_front(pos, 1, std::ref(func));
-        }
+    if constexpr (!std::forward_iterator<InputIt>) {
+        deque<T, Allocator> tmp_deque(first, last, alloc_);
+        return insert(pos, std::move_iterator<iterator>(tmp_deque.begin()),
+                      std::move_iterator<iterator>(tmp_deque.end()));
     } else {
-        for (; first != last; ++first) {
-            ret_val = insert_back(pos, 1, std::ref(func));
+        size_type cnt = std::distance(first, last);
+        size_type front_diff = pos - cbegin();
+        size_type back_diff = cend() - pos;
+        auto func = [&first]() -> decltype(auto) { return *first++; };
+        if (front_diff < back_diff) {
+            return insert_front(pos, cnt, func);
         }
+        return insert_back(pos, cnt, func);
     }
-    return ret_val;
 }
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::iterator deque<T, Allocator>::insert(const_iterator pos, std::initializer_list<T> ilist) {
-    size_type cnt = ilist.size();
-    typename std::initializer_list<T>::iterator ibegin = ilist.begin();
-    auto ibegin_ptr = &ibegin;
-
-    auto func = [ibegin_ptr]() {
-        auto ret_val = *(*ibegin_ptr);
-        ++(*ibegin_ptr);
-        return ret_val;
-    };
-
-    size_type front_diff = pos - begin();
-    size_type back_diff = end() - pos;
-
-    if (front_diff < back_diff) {
-        return insert_front(pos, cnt, std::ref(func));
-    }
-    return insert_back(pos, cnt, std::ref(func));
+    return insert(pos, ilist.begin(), ilist.end());
 }
 
 template <typename T>
@@ -817,192 +1058,40 @@ std::conditional_t<move_assign_if_noexcept_cond<T>::value, T&&, const T&> move_a
 template <typename T, typename Allocator>
 template <typename Func>
 deque<T, Allocator>::iterator deque<T, Allocator>::insert_front(const_iterator pos, size_type cnt, Func&& get_value) {
-    // allocate memory
-    difference_type front_cap = (curr_begin_node_ - start_node_) * buffer_size_ + begin_ind_;
-    size_type pos_ind = pos - begin();
-
-    if (front_cap < cnt) {
-        reallocate_pointers_map(cnt / buffer_size_ + 1);
-    }
-    map_pointer tmp_begin_node = curr_begin_node_;
-    size_type tmp_begin_ind = begin_ind_;
-
-    // установка новой начальной ноды (со сдвигом в cnt)
-    try {
-        for (size_type i = 0; i < cnt / buffer_size_; ++i, --curr_begin_node_) {
-            auto val = alloc_traits::allocate(alloc_, buffer_size_);
-            pmap_alloc_traits::construct(pmap_alloc_, curr_begin_node_, val);
-        }
-
-        if (begin_ind_ < cnt % buffer_size_) {
-            --curr_begin_node_;
-            auto val = alloc_traits::allocate(alloc_, buffer_size_);
-            pmap_alloc_traits::construct(pmap_alloc_, curr_begin_node_, val);
-
-            begin_ind_ = begin_ind_ + buffer_size_ - cnt % buffer_size_;
-
-        } else {
-            begin_ind_ -= cnt % buffer_size_;
-        }
-    } catch (const std::exception& e) {
-        for (; curr_begin_node_ != tmp_begin_node; ++curr_begin_node_) {
-            alloc_traits::deallocate(alloc_, *curr_begin_node_, buffer_size_);
-            pmap_alloc_traits::destroy(pmap_alloc_, curr_begin_node_);
-        }
-    }
-
-    size_type i, j, k;
-    map_pointer node = curr_begin_node_;
-    size_type ind = begin_ind_;
-    try {
-        // 1 step : construct elements on the allocated memory
-        for (i = 0; i < cnt && i < pos_ind; ++i) {
-            alloc_traits::construct(alloc_, *node + ind, std::move_if_noexcept(this->operator[](i + cnt)));
-            next_element(node, ind);
-        }
-
-        try {
-            // 2 step : construct new elements on the allocated memory (cnt > pos_ind) or move old elements (cnt
-            // <=pos_ind)
-
-            if (i == cnt) {  // move elements
-                for (j = cnt; j < pos_ind; ++j) {
-                    this->operator[](j) = move_assign_if_noexcept(this->operator[](j + cnt));
-                }
-            } else {  // construct
-                for (j = pos_ind; j < cnt; ++j) {
-                    alloc_traits::construct(alloc_, *node + ind, std::forward<value_type>(get_value()));
-                    next_element(node, ind);
-                }
-            }
-
-            // 3 step : move new elements
-            for (k = j; k < (pos_ind + cnt); ++k) {
-                this->operator[](k) = std::forward<value_type>(get_value());
-            }
-
-        } catch (const std::exception& e) {
-            if (i == cnt) {
-                for (; j > 0; --j) {
-                    this->operator[](j + cnt - 1) = move_assign_if_noexcept(this->operator[](j - 1));
-                }
-            } else {
-                for (j = pos_ind; j < cnt; ++j) {
-                    alloc_traits::destroy(alloc_, *node + ind);
-                    prev_element(node, ind);
-                }
-            }
-            throw e;
-        }
-    } catch (const std::exception& e) {
-        for (; i > 0; --i) {
-            this->operator[](i + cnt - 1) = move_assign_if_noexcept(*(*node + ind));
-            alloc_traits::destroy(alloc_, *node + ind);
-            prev_element(node, ind);
+    // the new elements are constructed before begin() (in reverse order) and rotated into place,
+    // only the elements before pos are moved
+    size_type pos_ind = pos - cbegin();
+    size_type i = 0;
+    DEQUE_TRY {
+        for (; i < cnt; ++i) {
+            emplace_front(get_value());
         }
-        curr_begin_node_ = tmp_begin_node;
-        begin_ind_ = tmp_begin_ind;
+    } DEQUE_CATCH {
+        pop_front_n(i);
+        DEQUE_RETHROW;
     }
+    std::reverse(begin(), begin() + cnt);
+    std::rotate(begin(), begin() + cnt, begin() + cnt + pos_ind);
     return begin() + pos_ind;
 }
 
 template <typename T, typename Allocator>
 template <typename Func>
 deque<T, Allocator>::iterator deque<T, Allocator>::insert_back(const_iterator pos, size_type cnt, Func&& get_value) {
-    // allocate memory
-    difference_type back_cap = (finish_node_ - curr_end_node_) * buffer_size_ + (buffer_size_ - end_ind_);
-    size_type pos_ind = end() - pos;
-
-    if (back_cap < cnt) {
-        reallocate_pointers_map(cnt / buffer_size_ + 1);
-    }
-
-    map_pointer tmp_end_node = curr_end_node_;
-    size_type tmp_end_ind = end_ind_;
-
-    try {
-        // установка новой конечной ноды (со сдвигом в cnt)
-
-        for (size_type i = 0; i < (cnt / buffer_size_); ++i, ++curr_end_node_) {
-            auto val = alloc_traits::allocate(alloc_, buffer_size_);
-            pmap_alloc_traits::construct(pmap_alloc_, curr_end_node_ + 1, val);
-        }
-
-        if ((end_ind_ + cnt % buffer_size_) > buffer_size_) {
-            ++curr_end_node_;
-            auto val = alloc_traits::allocate(alloc_, buffer_size_);
-            pmap_alloc_traits::construct(pmap_alloc_, curr_end_node_, val);
-        }
-        end_ind_ = (end_ind_ + cnt % buffer_size_) % buffer_size_;
-
-    } catch (const std::exception& e) {
-        for (; curr_end_node_ != tmp_end_node; --curr_end_node_) {
-            alloc_traits::deallocate(alloc_, *curr_end_node_, buffer_size_);
-            pmap_alloc_traits::destroy(pmap_alloc_, curr_end_node_);
-        }
-    }
-
-    size_type i, j, k;
-    map_pointer node = curr_end_node_;
-    size_type ind = end_ind_;
+    // the new elements are constructed after end() and rotated into place, only the elements after pos are moved
+    size_type pos_ind = pos - cbegin();
     size_type sz = size();
-    try {
-        // 1 step : construct elements on the allocated memory
-        for (i = 0; i < cnt && i < pos_ind; ++i) {
-            alloc_traits::construct(alloc_, *node + ind, std::move_if_noexcept(this->operator[](sz - cnt - i - 1)));
-            prev_element(node, ind);
-        }
-
-        try {
-            // 2 step : construct new elements on the allocated memory (cnt > pos_ind) or move old elements
-            // (cnt <=pos_ind)
-            if (i == cnt) {  // move elements
-                for (j = cnt; j < pos_ind; ++j) {
-                    this->operator[](sz - j - 1) = move_assign_if_noexcept(this->operator[](sz - j - cnt - 1));
-                }
-                for (k = pos_ind + cnt; k > pos_ind; --k) {
-                    std::cout << (sz - k) << std::endl;
-                    this->operator[](sz - k) = std::forward<value_type>(get_value());
-                }
-
-            } else {  // construct
-                for (k = pos_ind + cnt; k > cnt + 1; --k) {
-                    this->operator[](sz - k) = std::forward<value_type>(get_value());
-                }
-
-                for (auto i = 0; i < (cnt - pos_ind); ++i) {
-                    prev_element(node, ind);
-                }
-
-                for (j = pos_ind; j < cnt; ++j) {
-                    alloc_traits::construct(alloc_, *node + ind, std::forward<value_type>(get_value()));
-                    next_element(node, ind);
-                }
-            }
-
-        } catch (const std::exception& e) {
-            if (i == cnt) {
-                for (; j > 0; --j) {
-                    this->operator[](sz - (j + cnt - 1)) = move_assign_if_noexcept(this->operator[](sz - (j - 1)));
-                }
-            } else {
-                for (j = pos_ind; j < cnt; ++j) {
-                    alloc_traits::destroy(alloc_, *node + ind);
-                    next_element(node, ind);
-                }
-            }
-            throw e;
-        }
-    } catch (const std::exception& e) {
-        for (; i > 0; --i) {
-            this->operator[](sz - (i + cnt - 1)) = move_assign_if_noexcept(*(*node + ind));
-            alloc_traits::destroy(alloc_, *node + ind);
-            next_element(node, ind);
+    size_type i = 0;
+    DEQUE_TRY {
+        for (; i < cnt; ++i) {
+            emplace_back(get_value());
         }
-        curr_end_node_ = tmp_end_node;
-        end_ind_ = tmp_end_ind;
+    } DEQUE_CATCH {
+        pop_back_n(i);
+        DEQUE_RETHROW;
     }
-    return end() - pos_ind;
+    std::rotate(begin() + pos_ind, begin() + sz, end());
+    return begin() + pos_ind;
 }
 
 template <typename T, typename Allocator>
@@ -1036,24 +1125,35 @@ deque<T, Allocator>::PMapAlloc deque<T, Allocator>::get_pmap_allocator() const {
 }
 
 template <typename T, typename Allocator>
-deque<T, Allocator>::reference deque<T, Allocator>::operator[](size_type pos) {
-    map_pointer ret_node = curr_begin_node_;
-    size_type ret_ind = begin_ind_;
-
-    ret_node += pos / buffer_size_;
-    ret_ind += pos % buffer_size_;
-    if (ret_ind >= buffer_size_) {
-        ++ret_node;
-        ret_ind %= buffer_size_;
+void deque<T, Allocator>::locate(size_type pos, map_pointer& node, size_type& ind) const {
+    node = curr_begin_node_ + pos / buffer_size_;
+    ind = begin_ind_ + pos % buffer_size_;
+    if (ind >= buffer_size_) {
+        ++node;
+        ind -= buffer_size_;
     }
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::reference deque<T, Allocator>::operator[](size_type pos) {
+    map_pointer ret_node;
+    size_type ret_ind;
+    locate(pos, ret_node, ret_ind);
+    return *(*(ret_node) + ret_ind);
+}
 
+template <typename T, typename Allocator>
+deque<T, Allocator>::const_reference deque<T, Allocator>::operator[](size_type pos) const {
+    map_pointer ret_node;
+    size_type ret_ind;
+    locate(pos, ret_node, ret_ind);
     return *(*(ret_node) + ret_ind);
 }
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::reference deque<T, Allocator>::at(size_type pos) {
     if (pos >= size()) {
-        throw std::out_of_range("The size of container is smaller than the numbers in the function argument");
+        deque_throw(std::out_of_range("The size of container is smaller than the numbers in the function argument"));
     }
     return this->operator[](pos);
 }
@@ -1061,7 +1161,7 @@ deque<T, Allocator>::reference deque<T, Allocator>::at(size_type pos) {
 template <typename T, typename Allocator>
 deque<T, Allocator>::const_reference deque<T, Allocator>::at(size_type pos) const {
     if (pos >= size()) {
-        throw std::out_of_range("The size of container is smaller than the numbers in the function argument");
+        deque_throw(std::out_of_range("The size of container is smaller than the numbers in the function argument"));
     }
     return this->operator[](pos);
 }
@@ -1069,19 +1169,144 @@ deque<T, Allocator>::const_reference deque<T, Allocator>::at(size_type pos) cons
 template <typename T, typename Allocator>
 void deque<T, Allocator>::pop_back() {
     alloc_traits::destroy(alloc_, *curr_end_node_ + end_ind_ - 1);
-    if (end_ind_ == 1) {
-        alloc_traits::deallocate(alloc_, *curr_end_node_, buffer_size_);
+    if (--end_ind_ == 0) {
+        deallocate_node(curr_end_node_);
+        --curr_end_node_;
+        end_ind_ = buffer_size_;
     }
-    prev_element(curr_end_node_, end_ind_);
 }
 
 template <typename T, typename Allocator>
 void deque<T, Allocator>::pop_front() {
     alloc_traits::destroy(alloc_, *curr_begin_node_ + begin_ind_);
-    if (begin_ind_ == buffer_size_ - 1) {
-        alloc_traits::deallocate(alloc_, *curr_begin_node_, buffer_size_);
+    if (++begin_ind_ == buffer_size_) {
+        deallocate_node(curr_begin_node_);
+        ++curr_begin_node_;
+        begin_ind_ = 0;
+    }
+}
+
+template <typename T, typename Allocator>
+void deque<T, Allocator>::pop_front_n(size_type count) {
+    while (count > 0) {
+        size_type last_ind = (curr_begin_node_ == curr_end_node_) ? end_ind_ : buffer_size_;
+        size_type cnt = std::min(count, last_ind - begin_ind_);
+        destroy_range(*curr_begin_node_ + begin_ind_, *curr_begin_node_ + begin_ind_ + cnt);
+        begin_ind_ += cnt;
+        count -= cnt;
+        if (begin_ind_ == buffer_size_) {
+            deallocate_node(curr_begin_node_);
+            ++curr_begin_node_;
+            begin_ind_ = 0;
+        }
+    }
+}
+
+template <typename T, typename Allocator>
+void deque<T, Allocator>::pop_back_n(size_type count) {
+    while (count > 0) {
+        size_type first_ind = (curr_begin_node_ == curr_end_node_) ? begin_ind_ : 0;
+        size_type cnt = std::min(count, end_ind_ - first_ind);
+        destroy_range(*curr_end_node_ + end_ind_ - cnt, *curr_end_node_ + end_ind_);
+        end_ind_ -= cnt;
+        count -= cnt;
+        if (end_ind_ == 0) {
+            deallocate_node(curr_end_node_);
+            --curr_end_node_;
+            end_ind_ = buffer_size_;
+        }
+    }
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::size_type deque<T, Allocator>::drain_front(value_type* out, size_type max_cnt) {
+    if constexpr (!std::is_trivially_copyable_v<value_type>) {
+        return drain_front<value_type*>(out, max_cnt);
+    } else {
+        size_type cnt = std::min(max_cnt, size());
+        for (size_type left = cnt; left > 0;) {
+            size_type last_ind = (curr_begin_node_ == curr_end_node_) ? end_ind_ : buffer_size_;
+            size_type node_cnt = std::min(left, last_ind - begin_ind_);
+            std::memcpy(out, *curr_begin_node_ + begin_ind_, node_cnt * sizeof(value_type));
+            out += node_cnt;
+            left -= node_cnt;
+            pop_front_n(node_cnt);
+        }
+        return cnt;
+    }
+}
+
+template <typename T, typename Allocator>
+template <class OutputIt>
+deque<T, Allocator>::size_type deque<T, Allocator>::drain_front(OutputIt out, size_type max_cnt) {
+    size_type cnt = std::min(max_cnt, size());
+    for (size_type left = cnt; left > 0;) {
+        size_type last_ind = (curr_begin_node_ == curr_end_node_) ? end_ind_ : buffer_size_;
+        size_type node_cnt = std::min(left, last_ind - begin_ind_);
+        pointer first = *curr_begin_node_ + begin_ind_;
+        out = std::move(first, first + node_cnt, out);
+        left -= node_cnt;
+        pop_front_n(node_cnt);
     }
-    next_element(curr_begin_node_, begin_ind_);
+    return cnt;
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::segment_view deque<T, Allocator>::grow_back(size_type count) {
+    size_type sz = size();
+    append_nodes(count, [this](pointer dest, size_type node_cnt) { fill_range(dest, node_cnt); });
+    grown_back_ = count;
+
+    map_pointer node;
+    size_type ind;
+    locate(sz, node, ind);
+    return segment_view(node, ind, count, buffer_size_);
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::segment_view deque<T, Allocator>::grow_back_for_overwrite(size_type count) {
+    static_assert(std::is_trivially_default_constructible_v<T>,
+                  "The stored value must be trivially default constructible.");
+
+    size_type sz = size();
+    append_nodes(count, [](pointer, size_type) {});
+    grown_back_ = count;
+
+    map_pointer node;
+    size_type ind;
+    locate(sz, node, ind);
+    return segment_view(node, ind, count, buffer_size_);
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::segment_view deque<T, Allocator>::grow_front(size_type count) {
+    prepend_nodes(count, [this](pointer dest, size_type node_cnt) { fill_range(dest, node_cnt); });
+    grown_front_ = count;
+    return segment_view(curr_begin_node_, begin_ind_, count, buffer_size_);
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::segment_view deque<T, Allocator>::grow_front_for_overwrite(size_type count) {
+    static_assert(std::is_trivially_default_constructible_v<T>,
+                  "The stored value must be trivially default constructible.");
+
+    prepend_nodes(count, [](pointer, size_type) {});
+    grown_front_ = count;
+    return segment_view(curr_begin_node_, begin_ind_, count, buffer_size_);
+}
+
+template <typename T, typename Allocator>
+void deque<T, Allocator>::commit_back(size_type count) {
+    // the grown elements past the first count ones were not written; the deque may have been modified against the
+    // contract since grow_back, so no more than size() elements are removed
+    pop_back_n(std::min(grown_back_ - std::min(count, grown_back_), size()));
+    grown_back_ = 0;
+}
+
+template <typename T, typename Allocator>
+void deque<T, Allocator>::commit_front(size_type count) {
+    pop_front_n(std::min(grown_front_ - std::min(count, grown_front_), size()));
+    grown_front_ = 0;
 }
 
 template <typename T, typename Allocator>
@@ -1096,16 +1321,13 @@ void deque<T, Allocator>::resize(size_type count, const value_type& value) {
 
 template <typename T, typename Allocator>
 template <typename... Args>
-void deque<T, Allocator>::resize_templ(size_type cnt, Args... args) {
+void deque<T, Allocator>::resize_templ(size_type cnt, const Args&... args) {
     size_type sz = size();
     if (cnt > sz) {
-        for (size_type i = 0; i < cnt - sz; ++i) {
-            emplace_back(std::forward<Args>(args)...);
-        }
+        append_nodes(cnt - sz,
+                     [this, &args...](pointer dest, size_type node_cnt) { fill_range(dest, node_cnt, args...); });
     } else {
-        for (size_type i = 0; i < sz - cnt; ++i) {
-            pop_back();
-        }
+        pop_back_n(sz - cnt);
     }
 }
 
@@ -1122,73 +1344,675 @@ void deque<T, Allocator>::swap(deque& other) noexcept(std::allocator_traits<Allo
         std::swap(begin_ind_, other.begin_ind_);
         std::swap(end_ind_, other.end_ind_);
         std::swap(buffer_size_, other.buffer_size_);
+        std::swap(max_buffer_size_, other.max_buffer_size_);
+        std::swap(grown_back_, other.grown_back_);
+        std::swap(grown_front_, other.grown_front_);
     }
 }
 
 template <typename T, typename Allocator>
-void deque<T, Allocator>::assign(size_type count, const T& value) {
-    size_type sz = size();
+template <typename Pred>
+deque<T, Allocator>::iterator deque<T, Allocator>::partition_point_nodes(Pred pred) const {
+    // the first elements of the nodes are searched through the pointers map first, then the only node that can
+    // contain the partition point
+    if (empty() || !pred(front())) {
+        return make_iterator(curr_begin_node_, begin_ind_);
+    }
+    map_pointer node =
+        std::partition_point(curr_begin_node_ + 1, curr_end_node_ + 1, [&pred](pointer el) { return pred(*el); }) -
+        1;
+    size_type first_ind = (node == curr_begin_node_) ? begin_ind_ : 0;
+    size_type last_ind = (node == curr_end_node_) ? end_ind_ : buffer_size_;
+    pointer el = std::partition_point(*node + first_ind, *node + last_ind, pred);
+    return make_iterator(node, el - *node);
+}
 
-    deque<T, Allocator> tmp_deque(get_allocator());
-    size_type i;
-    try {
-        for (i = 0; i < count; ++i) {
-            if (i < sz) {
-                tmp_deque.emplace_back(value);
-                this->operator[](i) = value;
-            } else {
-                emplace_back(value);
+template <typename T, typename Allocator>
+template <typename K, typename Compare>
+deque<T, Allocator>::iterator deque<T, Allocator>::lower_bound(const K& key, Compare comp) {
+    return partition_point_nodes([&key, &comp](const value_type& el) { return comp(el, key); });
+}
+
+template <typename T, typename Allocator>
+template <typename K, typename Compare>
+deque<T, Allocator>::const_iterator deque<T, Allocator>::lower_bound(const K& key, Compare comp) const {
+    return partition_point_nodes([&key, &comp](const value_type& el) { return comp(el, key); });
+}
+
+template <typename T, typename Allocator>
+template <typename K, typename Compare>
+deque<T, Allocator>::iterator deque<T, Allocator>::upper_bound(const K& key, Compare comp) {
+    return partition_point_nodes([&key, &comp](const value_type& el) { return !comp(key, el); });
+}
+
+template <typename T, typename Allocator>
+template <typename K, typename Compare>
+deque<T, Allocator>::const_iterator deque<T, Allocator>::upper_bound(const K& key, Compare comp) const {
+    return partition_point_nodes([&key, &comp](const value_type& el) { return !comp(key, el); });
+}
+
+template <typename T, typename Allocator>
+template <typename K, typename Compare>
+std::pair<typename deque<T, Allocator>::iterator, typename deque<T, Allocator>::iterator>
+deque<T, Allocator>::equal_range(const K& key, Compare comp) {
+    return {lower_bound(key, comp), upper_bound(key, comp)};
+}
+
+template <typename T, typename Allocator>
+template <typename K, typename Compare>
+std::pair<typename deque<T, Allocator>::const_iterator, typename deque<T, Allocator>::const_iterator>
+deque<T, Allocator>::equal_range(const K& key, Compare comp) const {
+    return {lower_bound(key, comp), upper_bound(key, comp)};
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+deque<T, Allocator>::iterator deque<T, Allocator>::insert_sorted(const T& value, Compare comp) {
+    return insert(upper_bound(value, comp), value);
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+deque<T, Allocator>::iterator deque<T, Allocator>::insert_sorted(T&& value, Compare comp) {
+    return insert(upper_bound(value, comp), std::move(value));
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator> deque<T, Allocator>::split(const_iterator pos) {
+    size_type pos_ind = pos - cbegin();
+    size_type sz = size();
+    deque<T, Allocator> other(alloc_, pmap_alloc_);
+    // other receives nodes of buffer_size_ elements
+    other.adopt_block_size(*this);
+    if (pos_ind == sz) {
+        return other;
+    }
+
+    map_pointer node;
+    size_type ind;
+    locate(pos_ind, node, ind);
+
+    // the node containing pos is handed over as a whole if nothing before pos stays in it
+    bool copy_node = pos_ind != 0 && ind != 0;
+    map_pointer first_moved = copy_node ? node + 1 : node;
+    size_type nodes_cnt = curr_end_node_ - node + 1;
+
+    other.deallocate_map();
+    other.default_constr_with_memory_cap(nodes_cnt);
+
+    if (copy_node) {
+        size_type last_ind = (node == curr_end_node_) ? end_ind_ : buffer_size_;
+        *other.curr_begin_node_ = alloc_traits::allocate(alloc_, buffer_size_);
+        size_type i = ind;
+        DEQUE_TRY {
+            for (; i < last_ind; ++i) {
+                alloc_traits::construct(alloc_, *other.curr_begin_node_ + i, std::move_if_noexcept(*(*node + i)));
             }
+        } DEQUE_CATCH {
+            other.destroy_node(other.curr_begin_node_, ind, i);
+            DEQUE_RETHROW;
         }
-        for (; i < sz; ++i) {
-            pop_back();
+        for (i = ind; i < last_ind; ++i) {
+            alloc_traits::destroy(alloc_, *node + i);
         }
     }
 
-    catch (const std::exception& e) {
-        for (; i < sz; ++i) {
-            tmp_deque.emplace_back(std::move_if_noexcept(this->operator[](i)));
+    map_pointer other_node = other.curr_begin_node_ + (copy_node ? 1 : 0);
+    for (map_pointer p = first_moved; p <= curr_end_node_; ++p, ++other_node) {
+        *other_node = std::exchange(*p, nullptr);
+    }
+    other.curr_end_node_ = other.curr_begin_node_ + nodes_cnt - 1;
+    other.begin_ind_ = ind;
+    other.end_ind_ = end_ind_;
+
+    if (copy_node) {
+        curr_end_node_ = node;
+        end_ind_ = ind;
+    } else {
+        curr_end_node_ = node - 1;
+        end_ind_ = buffer_size_;
+        if (pos_ind == 0) {
+            begin_ind_ = 0;
         }
-        *this = tmp_deque;
     }
+    reallocate_pointers_map(1);
+
+    return other;
 }
 
 template <typename T, typename Allocator>
-template <class InputIt>
-void deque<T, Allocator>::assign(InputIt first, InputIt last) {
+template <typename Compare>
+void deque<T, Allocator>::sort(Compare comp) {
+    sort_nodes<false>(comp, 1);
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+void deque<T, Allocator>::stable_sort(Compare comp) {
+    sort_nodes<true>(comp, 1);
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+void deque<T, Allocator>::sort(deque_sort_threads threads, Compare comp) {
+    sort_nodes<false>(comp, threads.count != 0 ? threads.count : std::max(1u, std::thread::hardware_concurrency()));
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+void deque<T, Allocator>::stable_sort(deque_sort_threads threads, Compare comp) {
+    sort_nodes<true>(comp, threads.count != 0 ? threads.count : std::max(1u, std::thread::hardware_concurrency()));
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::size_type deque<T, Allocator>::node_begin(size_type node) const {
+    return node == 0 ? begin_ind_ : 0;
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::size_type deque<T, Allocator>::node_end(size_type node) const {
+    return curr_begin_node_ + node == curr_end_node_ ? end_ind_ : buffer_size_;
+}
+
+template <typename T, typename Allocator>
+template <typename Func>
+void deque<T, Allocator>::run_parallel(size_type cnt, size_type threads_cnt, Func&& func) {
+    size_type parts_cnt = std::min(cnt, threads_cnt);
+    if (parts_cnt <= 1) {
+        func(0, cnt);
+        return;
+    }
+    std::unique_ptr<std::thread[]> threads(new std::thread[parts_cnt]);
+    std::unique_ptr<std::exception_ptr[]> errors(new std::exception_ptr[parts_cnt]);
+    auto work = [&](size_type part) {
+        DEQUE_TRY {
+            func(cnt * part / parts_cnt, cnt * (part + 1) / parts_cnt);
+        } DEQUE_CATCH {
+            errors[part] = std::current_exception();
+        }
+    };
+    // the parts whose thread couldn't be started run on the calling thread
+    size_type started = 1;
+    for (; started < parts_cnt; ++started) {
+        DEQUE_TRY {
+            threads[started] = std::thread(work, started);
+        } DEQUE_CATCH {
+            break;
+        }
+    }
+    work(0);
+    for (size_type part = started; part < parts_cnt; ++part) {
+        work(part);
+    }
+    for (size_type part = 1; part < started; ++part) {
+        threads[part].join();
+    }
+    for (size_type part = 0; part < parts_cnt; ++part) {
+        if (errors[part]) {
+            std::rethrow_exception(errors[part]);
+        }
+    }
+}
+
+template <typename T, typename Allocator>
+template <bool Stable, typename Compare>
+void deque<T, Allocator>::sort_nodes(Compare& comp, size_type threads_cnt) {
     size_type sz = size();
+    if (sz < 2) {
+        return;
+    }
+    if constexpr (radix_sortable_<Compare>) {
+        if (sz >= radix_sort_min_) {
+            radix_sort<std::is_same_v<Compare, std::greater<>> || std::is_same_v<Compare, std::greater<T>>>();
+            return;
+        }
+    }
+    if constexpr (!std::is_nothrow_move_constructible_v<value_type>) {
+        // a move between blocks that throws couldn't be undone
+        if constexpr (Stable) {
+            std::stable_sort(begin(), end(), comp);
+        } else {
+            std::sort(begin(), end(), comp);
+        }
+        return;
+    } else {
+        size_type nodes_cnt = curr_end_node_ - curr_begin_node_ + 1;
+        size_type run_nodes = std::max<size_type>(1, deque_sort_run_bytes / (buffer_size_ * sizeof(value_type)));
+        size_type runs_cnt = (nodes_cnt + run_nodes - 1) / run_nodes;
+        run_parallel(runs_cnt, threads_cnt, [&](size_type first, size_type last) {
+            if (run_nodes == 1) {
+                for (size_type node = first; node < last; ++node) {
+                    pointer block = *(curr_begin_node_ + node);
+                    if constexpr (Stable) {
+                        std::stable_sort(block + node_begin(node), block + node_end(node), comp);
+                    } else {
+                        std::sort(block + node_begin(node), block + node_end(node), comp);
+                    }
+                }
+                return;
+            }
+            pointer scratch = alloc_traits::allocate(alloc_, run_nodes * buffer_size_);
+            DEQUE_TRY {
+                for (size_type run = first; run < last; ++run) {
+                    sort_run<Stable>(run * run_nodes, std::min(nodes_cnt, (run + 1) * run_nodes), scratch, comp);
+                }
+            } DEQUE_CATCH {
+                alloc_traits::deallocate(alloc_, scratch, run_nodes * buffer_size_);
+                DEQUE_RETHROW;
+            }
+            alloc_traits::deallocate(alloc_, scratch, run_nodes * buffer_size_);
+        });
+        if (runs_cnt == 1) {
+            return;
+        }
+
+        // a pass merges pairs of runs into out, then out replaces the live part of the map
+        map_pointer out = pmap_alloc_traits::allocate(pmap_alloc_, nodes_cnt);
+        for (size_type width = run_nodes; width < nodes_cnt; width *= 2) {
+            auto merge_part = [&](size_type first_pair, size_type last_pair) {
+                sort_spares spares;
+                std::exception_ptr error;
+                for (size_type pair = first_pair; pair < last_pair; ++pair) {
+                    size_type first = pair * 2 * width;
+                    size_type middle = std::min(nodes_cnt, first + width);
+                    size_type last = std::min(nodes_cnt, first + 2 * width);
+                    if (error) {
+                        std::copy(curr_begin_node_ + first, curr_begin_node_ + last, out + first);
+                        continue;
+                    }
+                    DEQUE_TRY {
+                        merge_runs(first, middle, last, out, spares, comp);
+                    } DEQUE_CATCH {
+                        error = std::current_exception();
+                    }
+                }
+                while (spares.cnt > 0) {
+                    alloc_traits::deallocate(alloc_, spares.blocks[--spares.cnt], buffer_size_);
+                }
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            };
+            DEQUE_TRY {
+                run_parallel((nodes_cnt + 2 * width - 1) / (2 * width), threads_cnt, merge_part);
+            } DEQUE_CATCH {
+                std::copy(out, out + nodes_cnt, curr_begin_node_);
+                pmap_alloc_traits::deallocate(pmap_alloc_, out, nodes_cnt);
+                DEQUE_RETHROW;
+            }
+            std::copy(out, out + nodes_cnt, curr_begin_node_);
+        }
+        pmap_alloc_traits::deallocate(pmap_alloc_, out, nodes_cnt);
+    }
+}
+
+template <typename T, typename Allocator>
+template <bool Stable, typename Compare>
+void deque<T, Allocator>::sort_run(size_type first, size_type last, pointer scratch, Compare& comp) {
+    pointer scratch_last = scratch;
+    for (size_type node = first; node < last; ++node) {
+        size_type cnt = node_end(node) - node_begin(node);
+        relocate(scratch_last, *(curr_begin_node_ + node) + node_begin(node), cnt);
+        scratch_last += cnt;
+    }
+    auto move_back = [&]() {
+        pointer from = scratch;
+        for (size_type node = first; node < last; ++node) {
+            size_type cnt = node_end(node) - node_begin(node);
+            relocate(*(curr_begin_node_ + node) + node_begin(node), from, cnt);
+            from += cnt;
+        }
+    };
+    DEQUE_TRY {
+        if constexpr (Stable) {
+            std::stable_sort(scratch, scratch_last, comp);
+        } else {
+            std::sort(scratch, scratch_last, comp);
+        }
+    } DEQUE_CATCH {
+        move_back();
+        DEQUE_RETHROW;
+    }
+    move_back();
+}
+
+template <typename T, typename Allocator>
+template <typename Compare>
+void deque<T, Allocator>::merge_runs(size_type first, size_type middle, size_type last, map_pointer out,
+                                     sort_spares& spares, Compare& comp) {
+    map_pointer nodes = curr_begin_node_;
+    bool sorted = true;
+    DEQUE_TRY {
+        while (spares.cnt < sort_spare_blocks_) {
+            spares.blocks[spares.cnt++] = alloc_traits::allocate(alloc_, buffer_size_);
+        }
+        sorted = middle == last ||
+                 !comp(*(*(nodes + middle) + node_begin(middle)), *(*(nodes + middle - 1) + node_end(middle - 1) - 1));
+    } DEQUE_CATCH {
+        std::copy(nodes + first, nodes + last, out + first);
+        DEQUE_RETHROW;
+    }
+    if (sorted) {
+        std::copy(nodes + first, nodes + last, out + first);
+        return;
+    }
 
-    deque<T, Allocator> tmp_deque(get_allocator());
-    size_type i;
-    try {
-        for (i = 0; first != last; ++first, ++i) {
-            if (i < sz) {
-                tmp_deque.emplace_back(std::move_if_noexcept(this->operator[](i)));
-                this->operator[](i) = (*first);
+    // the output has the layout of the input, so a block is released for about every block written: an output
+    // block is taken when the inputs are consumed up to its start
+    size_type a_node = first;
+    pointer a = *(nodes + a_node) + node_begin(a_node);
+    pointer a_end = *(nodes + a_node) + node_end(a_node);
+    size_type b_node = middle;
+    pointer b = *(nodes + b_node) + node_begin(b_node);
+    pointer b_end = *(nodes + b_node) + node_end(b_node);
+    size_type out_node = first;
+    *(out + out_node) = take_spare(spares);
+    pointer dest = *(out + out_node) + node_begin(out_node);
+    pointer dest_end = *(out + out_node) + node_end(out_node);
+    auto next_dest = [&]() {
+        ++out_node;
+        *(out + out_node) = take_spare(spares);
+        dest = *(out + out_node) + node_begin(out_node);
+        dest_end = *(out + out_node) + node_end(out_node);
+    };
+    // moves what is left of a run to the output, releasing its blocks
+    auto drain = [&](size_type& node, pointer& curr, pointer& curr_end, size_type last_node) {
+        while (node != last_node) {
+            while (curr != curr_end) {
+                if (dest == dest_end) {
+                    next_dest();
+                }
+                size_type cnt = std::min(curr_end - curr, dest_end - dest);
+                relocate(dest, curr, cnt);
+                dest += cnt;
+                curr += cnt;
+            }
+            release_spare(spares, *(nodes + node));
+            if (++node != last_node) {
+                curr = *(nodes + node) + node_begin(node);
+                curr_end = *(nodes + node) + node_end(node);
+            }
+        }
+    };
+
+    DEQUE_TRY {
+        while (true) {
+            if (dest == dest_end) {
+                next_dest();
+            }
+            // no cursor reaches the end of its block within steps elements
+            size_type steps = std::min({a_end - a, b_end - b, dest_end - dest});
+            if constexpr (bitwise_copyable_) {
+                for (; steps > 0; --steps) {
+                    bool take_b = comp(*b, *a);
+                    *dest++ = take_b ? *b : *a;
+                    b += take_b;
+                    a += !take_b;
+                }
             } else {
-                emplace_back(*first);
+                for (; steps > 0; --steps) {
+                    pointer& src = comp(*b, *a) ? b : a;
+                    alloc_traits::construct(alloc_, dest++, std::move(*src));
+                    alloc_traits::destroy(alloc_, src++);
+                }
+            }
+            if (a == a_end) {
+                release_spare(spares, *(nodes + a_node));
+                if (++a_node == middle) {
+                    break;
+                }
+                a = *(nodes + a_node) + node_begin(a_node);
+                a_end = *(nodes + a_node) + node_end(a_node);
+            }
+            if (b == b_end) {
+                release_spare(spares, *(nodes + b_node));
+                if (++b_node == last) {
+                    break;
+                }
+                b = *(nodes + b_node) + node_begin(b_node);
+                b_end = *(nodes + b_node) + node_end(b_node);
             }
         }
-        for (; i < sz; ++i) {
-            pop_back();
+    } DEQUE_CATCH {
+        drain(a_node, a, a_end, middle);
+        drain(b_node, b, b_end, last);
+        DEQUE_RETHROW;
+    }
+    if (a_node != middle) {
+        drain(a_node, a, a_end, middle);
+        return;
+    }
+    // the rest of the second run is already where it belongs: only its current block is moved, and the following
+    // ones are handed over
+    if (b_node != last) {
+        size_type rest_node = b_node + 1;
+        pointer rest_end = b_end;
+        drain(b_node, b, rest_end, rest_node);
+        std::copy(nodes + rest_node, nodes + last, out + rest_node);
+    }
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::pointer deque<T, Allocator>::take_spare(sort_spares& spares) {
+    if (spares.cnt == 0) {
+        return alloc_traits::allocate(alloc_, buffer_size_);
+    }
+    return spares.blocks[--spares.cnt];
+}
+
+template <typename T, typename Allocator>
+void deque<T, Allocator>::release_spare(sort_spares& spares, pointer block) {
+    if (spares.cnt == sort_spare_blocks_ + 1) {
+        alloc_traits::deallocate(alloc_, block, buffer_size_);
+        return;
+    }
+    spares.blocks[spares.cnt++] = block;
+}
+
+template <typename T, typename Allocator>
+void deque<T, Allocator>::relocate(pointer dest, pointer src, size_type cnt) {
+    if constexpr (bitwise_copyable_) {
+        std::memcpy(static_cast<void*>(dest), src, cnt * sizeof(value_type));
+    } else {
+        for (size_type i = 0; i < cnt; ++i) {
+            alloc_traits::construct(alloc_, dest + i, std::move(src[i]));
+            alloc_traits::destroy(alloc_, src + i);
         }
     }
+}
 
-    catch (const std::exception& e) {
-        for (; i < sz; ++i) {
-            tmp_deque.emplace_back(std::move_if_noexcept(this->operator[](i)));
+template <typename T, typename Allocator>
+template <bool Descending>
+void deque<T, Allocator>::radix_sort() {
+    // LSD radix sort by bytes, between the nodes and a scratch buffer; a byte that is the same in all elements is
+    // skipped. The sign bit is flipped so that negative numbers come first, all bits for the descending order
+    using key_type = std::make_unsigned_t<value_type>;
+    constexpr size_type digits = sizeof(value_type);
+    constexpr key_type flip = key_type((std::is_signed_v<value_type> ? key_type(1) << (digits * 8 - 1) : 0) ^
+                                       (Descending ? key_type(~key_type(0)) : 0));
+    auto digit = [](value_type value, size_type d) {
+        return static_cast<size_type>(key_type(key_type(value) ^ flip) >> (d * 8) & 0xFF);
+    };
+    size_type sz = size();
+    size_type counts[digits][256] = {};
+    for_each_segment(0, sz, [&](pointer first, pointer last) {
+        for (; first != last; ++first) {
+            for (size_type d = 0; d < digits; ++d) {
+                ++counts[d][digit(*first, d)];
+            }
+        }
+    });
+
+    pointer scratch = alloc_traits::allocate(alloc_, sz);
+    bool in_scratch = false;
+    for (size_type d = 0; d < digits; ++d) {
+        size_type* count = counts[d];
+        if (std::find(count, count + 256, sz) != count + 256) {
+            continue;
+        }
+        size_type offsets[256];
+        size_type sum = 0;
+        for (size_type v = 0; v < 256; ++v) {
+            offsets[v] = sum;
+            sum += count[v];
         }
-        *this = tmp_deque;
+        if (!in_scratch) {
+            for_each_segment(0, sz, [&](pointer first, pointer last) {
+                for (; first != last; ++first) {
+                    scratch[offsets[digit(*first, d)]++] = *first;
+                }
+            });
+        } else {
+            // a cursor per byte value walks the nodes from the first position of its elements
+            pointer curr[256];
+            pointer curr_end[256];
+            map_pointer node[256];
+            for (size_type v = 0; v < 256; ++v) {
+                if (count[v] != 0) {
+                    size_type ind;
+                    locate(offsets[v], node[v], ind);
+                    curr[v] = *node[v] + ind;
+                    curr_end[v] = *node[v] + buffer_size_;
+                }
+            }
+            for (pointer from = scratch; from != scratch + sz; ++from) {
+                size_type v = digit(*from, d);
+                if (curr[v] == curr_end[v]) {
+                    curr[v] = *++node[v];
+                    curr_end[v] = curr[v] + buffer_size_;
+                }
+                *curr[v]++ = *from;
+            }
+        }
+        in_scratch = !in_scratch;
+    }
+    if (in_scratch) {
+        pointer from = scratch;
+        for_each_segment(0, sz, [&from](pointer first, pointer last) {
+            std::memcpy(static_cast<void*>(first), from, (last - first) * sizeof(value_type));
+            from += last - first;
+        });
     }
+    alloc_traits::deallocate(alloc_, scratch, sz);
 }
 
 template <typename T, typename Allocator>
-void deque<T, Allocator>::assign(std::initializer_list<T> ilist) {
-    size_type capacity = size() + (finish_node_ - curr_end_node_ - 1) * buffer_size_ + (buffer_size_ - end_ind_);
-    if (capacity < ilist.size()) {
-        size_type offset_sz = (ilist.size() - capacity) / buffer_size_ + 1;
-        reallocate_pointers_map(offset_sz);
+template <typename Func>
+void deque<T, Allocator>::for_each_segment(size_type pos, size_type cnt, Func&& func) const {
+    // func(first, last) is called for every contiguous chunk of [pos, pos + cnt)
+    map_pointer node;
+    size_type ind;
+    locate(pos, node, ind);
+    while (cnt > 0) {
+        size_type node_cnt = std::min(cnt, buffer_size_ - ind);
+        prefetch_node(*(node + deque_prefetch_distance), buffer_size_ * sizeof(value_type));
+        func(*node + ind, *node + ind + node_cnt);
+        cnt -= node_cnt;
+        ++node;
+        ind = 0;
+    }
+}
+
+template <typename T, typename Allocator>
+template <typename Func>
+bool deque<T, Allocator>::for_each_common_segment(const deque& other, size_type cnt, Func&& func) const {
+    // the block sizes and offsets may differ, so the chunks end wherever either side reaches the end of a block
+    map_pointer node = curr_begin_node_;
+    size_type ind = begin_ind_;
+    map_pointer other_node = other.curr_begin_node_;
+    size_type other_ind = other.begin_ind_;
+    while (cnt > 0) {
+        size_type chunk_cnt = std::min({cnt, buffer_size_ - ind, other.buffer_size_ - other_ind});
+        if (!func(static_cast<const_pointer>(*node + ind), static_cast<const_pointer>(*node + ind + chunk_cnt),
+                  static_cast<const_pointer>(*other_node + other_ind))) {
+            return false;
+        }
+        cnt -= chunk_cnt;
+        ind += chunk_cnt;
+        other_ind += chunk_cnt;
+        if (ind == buffer_size_) {
+            ++node;
+            ind = 0;
+            prefetch_node(*(node + deque_prefetch_distance), buffer_size_ * sizeof(value_type));
+        }
+        if (other_ind == other.buffer_size_) {
+            ++other_node;
+            other_ind = 0;
+            prefetch_node(*(other_node + deque_prefetch_distance), other.buffer_size_ * sizeof(value_type));
+        }
+    }
+    return true;
+}
+
+template <typename T, typename Allocator>
+void deque<T, Allocator>::assign(size_type count, const T& value) {
+    if constexpr (!std::is_nothrow_copy_assignable_v<value_type> ||
+                  !std::is_nothrow_copy_constructible_v<value_type>) {
+        // keeps the old content if copying throws
+        deque<T, Allocator> tmp_deque(alloc_, pmap_alloc_);
+        tmp_deque.adopt_block_size(*this);
+        tmp_deque.resize_templ(count, value);
+        swap(tmp_deque);
+    } else {
+        size_type sz = size();
+        for_each_segment(0, std::min(count, sz),
+                         [&value](pointer first, pointer last) { std::fill(first, last, value); });
+        if (count < sz) {
+            pop_back_n(sz - count);
+        } else {
+            resize_templ(count, value);
+        }
+    }
+}
+
+template <typename T, typename Allocator>
+template <class InputIt>
+void deque<T, Allocator>::assign(InputIt first, InputIt last) {
+    using reference_type = std::iter_reference_t<InputIt>;
+    if constexpr (!std::is_nothrow_assignable_v<value_type&, reference_type> ||
+                  !std::is_nothrow_constructible_v<value_type, reference_type>) {
+        // keeps the old content if copying throws
+        deque<T, Allocator> tmp_deque(alloc_, pmap_alloc_);
+        tmp_deque.adopt_block_size(*this);
+        if constexpr (std::forward_iterator<InputIt>) {
+            tmp_deque.append_n(first, std::distance(first, last));
+        } else {
+            for (; first != last; ++first) {
+                tmp_deque.emplace_back(*first);
+            }
+        }
+        swap(tmp_deque);
+    } else if constexpr (std::forward_iterator<InputIt>) {
+        // the elements are overwritten in place, the missing ones are constructed after a single map reallocation
+        size_type count = std::distance(first, last);
+        size_type sz = size();
+        for_each_segment(0, std::min(count, sz), [&first](pointer dest_first, pointer dest_last) {
+            for (; dest_first != dest_last; ++dest_first, ++first) {
+                *dest_first = *first;
+            }
+        });
+        if (count < sz) {
+            pop_back_n(sz - count);
+        } else {
+            append_n(first, count - sz);
+        }
+    } else {
+        size_type sz = size();
+        size_type i = 0;
+        for_each_segment(0, sz, [&first, &last, &i](pointer dest_first, pointer dest_last) {
+            for (; dest_first != dest_last && first != last; ++dest_first, ++first, ++i) {
+                *dest_first = *first;
+            }
+        });
+        pop_back_n(sz - i);
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
     }
+}
+
+template <typename T, typename Allocator>
+void deque<T, Allocator>::assign(std::initializer_list<T> ilist) {
     assign(ilist.begin(), ilist.end());
 }
 
@@ -1212,12 +2036,22 @@ deque<T, Allocator>& deque<T, Allocator>::operator=(deque&& other) noexcept(
         pmap_alloc_ = other.get_pmap_allocator();
     }
 
+    if (this == &other) {
+        return *this;
+    }
+    clear();
+    deallocate_map();
+
     start_node_ = other.start_node_;
     finish_node_ = other.finish_node_;
     curr_begin_node_ = other.curr_begin_node_;
     curr_end_node_ = other.curr_end_node_;
     begin_ind_ = other.begin_ind_;
     end_ind_ = other.end_ind_;
+    buffer_size_ = other.buffer_size_;
+    max_buffer_size_ = other.max_buffer_size_;
+    grown_back_ = std::exchange(other.grown_back_, 0);
+    grown_front_ = std::exchange(other.grown_front_, 0);
     other.default_constr_with_memory_cap(0);
 
     return *this;
@@ -1226,16 +2060,65 @@ deque<T, Allocator>& deque<T, Allocator>::operator=(deque&& other) noexcept(
 template <typename T, typename Allocator>
 void deque<T, Allocator>::move_assign_each_element_individually(deque&& other) {
     assign(std::move_iterator<iterator>(other.begin()), std::move_iterator<iterator>(other.end()));
+    grown_back_ = std::exchange(other.grown_back_, 0);
+    grown_front_ = std::exchange(other.grown_front_, 0);
     other.clear();
 }
 
 template <typename T, typename Allocator>
 void deque<T, Allocator>::copy_assign_each_element_individually(const deque& other) {
-    assign(other.begin(), other.end());
+    // assigns over the live elements, then constructs the rest of other at the end or drops the extra tail
+    size_type other_sz = other.size();
+    size_type sz = size();
+    size_type left = std::min(sz, other_sz);
+
+    map_pointer node = curr_begin_node_;
+    size_type ind = begin_ind_;
+    map_pointer other_node = other.curr_begin_node_;
+    size_type other_ind = other.begin_ind_;
+    while (left > 0) {
+        size_type cnt = std::min({left, buffer_size_ - ind, other.buffer_size_ - other_ind});
+        std::copy(*other_node + other_ind, *other_node + other_ind + cnt, *node + ind);
+        left -= cnt;
+        if ((ind += cnt) == buffer_size_) {
+            ++node;
+            ind = 0;
+        }
+        if ((other_ind += cnt) == other.buffer_size_) {
+            ++other_node;
+            other_ind = 0;
+        }
+    }
+
+    if (sz > other_sz) {
+        pop_back_n(sz - other_sz);
+        return;
+    }
+    for (left = other_sz - sz; left > 0;) {
+        size_type cnt = std::min(left, other.buffer_size_ - other_ind);
+        append_n(*other_node + other_ind, cnt);
+        left -= cnt;
+        ++other_node;
+        other_ind = 0;
+    }
 }
 
 template <typename T, typename Allocator>
 deque<T, Allocator>& deque<T, Allocator>::operator=(const deque& other) {
+    if (this == &other) {
+        return *this;
+    }
+    if (alloc_traits::propagate_on_container_copy_assignment::value && alloc_ != other.alloc_) {
+        // the nodes can't be released by the new allocator
+        clear();
+        deallocate_map();
+        alloc_ = other.get_allocator();
+        pmap_alloc_ = other.get_pmap_allocator();
+        default_constr_with_memory_cap(0);
+        // appends element by element, as copy_nodes would take the block size of other
+        copy_assign_each_element_individually(other);
+        return *this;
+    }
     if (alloc_traits::propagate_on_container_copy_assignment::value) {
         alloc_ = other.get_allocator();
     }
@@ -1265,46 +2148,121 @@ deque<T, Allocator>::iterator deque<T, Allocator>::erase(const_iterator first, c
 
 template <typename T, typename Allocator>
 deque<T, Allocator>::iterator deque<T, Allocator>::erase_back(const_iterator first, const_iterator last) {
-    if (first == last) return last;
+    if (first == last) return iterator(last);
     difference_type back_diff = end() - last;
     difference_type diff = last - first;
-    iterator it1 = first;
-    iterator it2 = last;
-    try {
-        for (; it2 != end(); ++it2, ++it1) {
-            swap_elemets(*it1, *it2);
-        }
-        for (auto i = 0; i < diff; ++i) {
-            pop_back();
-        }
-    } catch (const std::exception& e) {
-        for (; it2 != last; --it2, --it1) {
-            swap_elemets(*it1, *it2);
+    iterator it1(first);
+    iterator it2(last);
+    if constexpr (std::is_nothrow_move_assignable_v<value_type>) {
+        std::move(it2, end(), it1);
+    } else {
+        // the elements are swapped, so they can be swapped back if an assignment throws
+        DEQUE_TRY {
+            for (; it2 != end(); ++it2, ++it1) {
+                swap_elemets(*it1, *it2);
+            }
+        } DEQUE_CATCH {
+            for (; it2 != iterator(last); --it2, --it1) {
+                swap_elemets(*(it1 - 1), *(it2 - 1));
+            }
+            DEQUE_RETHROW;
         }
     }
+    pop_back_n(diff);
     return end() - back_diff;
 }
 
+template <typename T, typename Allocator>
+template <class Pred>
+deque<T, Allocator>::size_type deque<T, Allocator>::remove_if(Pred pred) {
+    return compact([&pred](value_type& value, const_pointer) { return static_cast<bool>(pred(value)); });
+}
+
+template <typename T, typename Allocator>
+deque<T, Allocator>::size_type deque<T, Allocator>::unique() {
+    return unique(std::equal_to<>());
+}
+
+template <typename T, typename Allocator>
+template <class BinaryPred>
+deque<T, Allocator>::size_type deque<T, Allocator>::unique(BinaryPred pred) {
+    return compact([&pred](value_type& value, const_pointer last_kept) {
+        return last_kept != nullptr && static_cast<bool>(pred(*last_kept, value));
+    });
+}
+
+template <typename T, typename Allocator>
+template <typename Pred>
+deque<T, Allocator>::size_type deque<T, Allocator>::compact(Pred drop) {
+    // the read and write cursors walk the blocks once. The read blocks are cut into pieces that fit into what is left
+    // of the write block, so the inner loop has no block checks; trivially copyable elements are stored
+    // unconditionally and the write cursor advances only past the kept ones, which avoids a branch per element.
+    // All elements stay constructed until the tail is popped, so an exception leaves a valid deque
+    size_type sz = size();
+    if (sz == 0) {
+        return 0;
+    }
+    map_pointer write_node = curr_begin_node_;
+    pointer dest = *write_node + begin_ind_;
+    pointer dest_last = *write_node + buffer_size_;
+    // the last kept element, or for trivially copyable types the previous one, which is equal to it for unique
+    const_pointer last_kept = nullptr;
+    for_each_segment(0, sz, [&](pointer first, pointer last) {
+        while (first != last) {
+            if (dest == dest_last) {
+                ++write_node;
+                dest = *write_node;
+                dest_last = dest + buffer_size_;
+            }
+            pointer piece_last = first + std::min(last - first, dest_last - dest);
+            for (; first != piece_last; ++first) {
+                if constexpr (std::is_trivially_copyable_v<value_type>) {
+                    // the previous element is still in place, the stores are at or behind the read cursor
+                    bool keep = !drop(*first, last_kept);
+                    *dest = *first;
+                    last_kept = first;
+                    dest += keep;
+                } else if (!drop(*first, last_kept)) {
+                    if (dest != first) {
+                        *dest = std::move(*first);
+                    }
+                    last_kept = dest++;
+                }
+            }
+        }
+    });
+    size_type kept = (write_node - curr_begin_node_) * buffer_size_ + (dest - *write_node) - begin_ind_;
+    if (kept == 0) {
+        clear();
+    } else {
+        pop_back_n(sz - kept);
+    }
+    return sz - kept;
+}
+
 template <typename T, typename Allocator>
 deque<T, Allocator>::iterator deque<T, Allocator>::erase_front(const_iterator first, const_iterator last) {
-    if (first == last) return last;
+    if (first == last) return iterator(last);
     difference_type front_diff = first - begin();
     difference_type diff = last - first;
-    iterator it1 = first - 1;
-    iterator it2 = last - 1;
-    size_type i;
-    try {
-        for (i = 0; i < front_diff; ++i, --it2, --it1) {
-            swap_elemets(*it1, *it2);
-        }
-        for (auto j = 0; j < diff; ++j) {
-            pop_front();
-        }
-    } catch (const std::exception& e) {
-        for (; i > 0; --it2, --it1) {
-            swap_elemets(*it1, *it2);
+    if constexpr (std::is_nothrow_move_assignable_v<value_type>) {
+        std::move_backward(begin(), iterator(first), iterator(last));
+    } else {
+        iterator it1(first);
+        iterator it2(last);
+        difference_type i = 0;
+        DEQUE_TRY {
+            for (; i < front_diff; ++i) {
+                swap_elemets(*--it1, *--it2);
+            }
+        } DEQUE_CATCH {
+            for (; i > 0; --i) {
+                swap_elemets(*++it1, *++it2);
+            }
+            DEQUE_RETHROW;
         }
     }
+    pop_front_n(diff);
     return begin() + front_diff;
 }
 
@@ -1326,41 +2284,34 @@ void swap(deque<T, Alloc>& lhs, deque<T, Alloc>& rhs) noexcept(noexcept(lhs.swap
 
 template <class T, class Alloc>
 bool operator==(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
+    using const_pointer = typename deque<T, Alloc>::const_pointer;
     if (lhs.size() != rhs.size()) {
         return false;
     }
-    for (typename deque<T, Alloc>::size_type i = 0; i < lhs.size(); ++i) {
-        if (lhs[i] != rhs[i]) {
-            return false;
+    return lhs.for_each_common_segment(rhs, lhs.size(), [](const_pointer first, const_pointer last, const_pointer other) {
+        if constexpr (deque<T, Alloc>::bytewise_comparable_) {
+            return std::memcmp(first, other, (last - first) * sizeof(T)) == 0;
+        } else {
+            return std::equal(first, last, other);
         }
-    }
-    return true;
+    });
 }
 
 #if __cplusplus >= 202602L
 template <class T, class Alloc, class U = T>
 constexpr typename deque<T, Alloc>::size_type erase(deque<T, Alloc>& c, const U& value) {
-    auto it = std::remove(c.begin(), c.end(), value);
-    typename deque<T, Alloc>::size_type r = c.end() - it;
-    c.erase(it, c.end());
-    return r;
+    return c.remove_if([&value](const T& elem) { return elem == value; });
 }
 #else
 template <class T, class Alloc, class U>
 typename deque<T, Alloc>::size_type erase(deque<T, Alloc>& c, const U& value) {
-    auto it = std::remove(c.begin(), c.end(), value);
-    typename deque<T, Alloc>::size_type r = c.end() - it;
-    c.erase(it, c.end());
-    return r;
+    return c.remove_if([&value](const T& elem) { return elem == value; });
 }
 #endif
 
 template <class T, class Alloc, class Pred>
 typename deque<T, Alloc>::size_type erase_if(deque<T, Alloc>& c, Pred pred) {
-    auto it = std::remove_if(c.begin(), c.end(), pred);
-    typename deque<T, Alloc>::size_type r = c.end() - it;
-    c.erase(it, c.end());
-    return r;
+    return c.remove_if(pred);
 }
 
 template <typename U>
@@ -1385,5 +2336,112 @@ constexpr auto synth_three_way = []<class T, class U>(const T& t, const U& u)
 
 template <class T, class Alloc>
 constexpr auto operator<=>(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
-    return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), synth_three_way);
+    // the common prefix is compared chunk by chunk over raw pointers, bytewise comparable chunks are skipped with
+    // memcmp and searched for the first difference only if they differ
+    using const_pointer = typename deque<T, Alloc>::const_pointer;
+    using result_type = decltype(synth_three_way(std::declval<const T&>(), std::declval<const T&>()));
+    result_type result = std::strong_ordering::equal;
+    lhs.for_each_common_segment(rhs, std::min(lhs.size(), rhs.size()),
+                                [&result](const_pointer first, const_pointer last, const_pointer other) {
+                                    if constexpr (deque<T, Alloc>::bytewise_comparable_) {
+                                        if (std::memcmp(first, other, (last - first) * sizeof(T)) == 0) {
+                                            return true;
+                                        }
+                                    }
+                                    for (; first != last; ++first, ++other) {
+                                        result = synth_three_way(*first, *other);
+                                        if (result != 0) {
+                                            return false;
+                                        }
+                                    }
+                                    return true;
+                                });
+    if (result != 0) {
+        return result;
+    }
+    return static_cast<result_type>(lhs.size() <=> rhs.size());
+}
+
+inline std::uint64_t deque_hash_state::mix(std::uint64_t lane, std::uint64_t word) {
+    return std::rotl(lane ^ (word * 0x9E3779B97F4A7C15), 31) * 0xBF58476D1CE4E5B9;
+}
+
+inline void deque_hash_state::add_word(std::uint64_t word) {
+    lanes_[count_ % lanes_cnt_] = mix(lanes_[count_ % lanes_cnt_], word);
+    ++count_;
+}
+
+inline void deque_hash_state::add_bytes(const void* data, std::size_t bytes) {
+    // whole words are read directly, the bytes that don't fill one wait in pending_ for the next call
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    constexpr std::size_t word_size = sizeof(std::uint64_t);
+    auto load = [](const unsigned char* from) {
+        std::uint64_t word;
+        std::memcpy(&word, from, word_size);
+        return word;
+    };
+    if (pending_bytes_ != 0) {
+        std::size_t cnt = std::min(bytes, word_size - pending_bytes_);
+        std::memcpy(pending_ + pending_bytes_, p, cnt);
+        pending_bytes_ += cnt;
+        p += cnt;
+        bytes -= cnt;
+        if (pending_bytes_ < word_size) {
+            return;
+        }
+        add_word(load(pending_));
+        pending_bytes_ = 0;
+    }
+    for (; bytes >= word_size && count_ % lanes_cnt_ != 0; p += word_size, bytes -= word_size) {
+        add_word(load(p));
+    }
+    // the lanes are independent, so the multiplications of consecutive words overlap
+    std::uint64_t lane0 = lanes_[0], lane1 = lanes_[1], lane2 = lanes_[2], lane3 = lanes_[3];
+    for (; bytes >= lanes_cnt_ * word_size; p += lanes_cnt_ * word_size, bytes -= lanes_cnt_ * word_size) {
+        lane0 = mix(lane0, load(p));
+        lane1 = mix(lane1, load(p + word_size));
+        lane2 = mix(lane2, load(p + 2 * word_size));
+        lane3 = mix(lane3, load(p + 3 * word_size));
+        count_ += lanes_cnt_;
+    }
+    lanes_[0] = lane0, lanes_[1] = lane1, lanes_[2] = lane2, lanes_[3] = lane3;
+    for (; bytes >= word_size; p += word_size, bytes -= word_size) {
+        add_word(load(p));
+    }
+    std::memcpy(pending_, p, bytes);
+    pending_bytes_ = bytes;
+}
+
+inline std::size_t deque_hash_state::finish() {
+    if (pending_bytes_ != 0) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, pending_, pending_bytes_);
+        add_word(word ^ (std::uint64_t(pending_bytes_) << 56));
+        pending_bytes_ = 0;
+    }
+    std::uint64_t h = count_;
+    for (std::uint64_t lane : lanes_) {
+        h = mix(h, lane);
+    }
+    h = (h ^ (h >> 33)) * 0xFF51AFD7ED558CCD;
+    h = (h ^ (h >> 33)) * 0xC4CEB9FE1A85EC53;
+    return static_cast<std::size_t>(h ^ (h >> 33));
+}
+
+template <class T, class Alloc>
+    requires requires(const T& value) { std::hash<T>{}(value); }
+std::size_t std::hash<deque<T, Alloc>>::operator()(const deque<T, Alloc>& d) const {
+    using const_pointer = typename deque<T, Alloc>::const_pointer;
+    deque_hash_state state;
+    d.for_each_segment(0, d.size(), [&state](const_pointer first, const_pointer last) {
+        if constexpr (deque<T, Alloc>::bytewise_comparable_) {
+            state.add_bytes(first, (last - first) * sizeof(T));
+        } else {
+            for (; first != last; ++first) {
+                state.add_word(std::hash<T>{}(*first));
+            }
+        }
+    });
+    state.add_word(d.size());
+    return state.finish();
 }
@@ -0,0 +1,113 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "block_pool.h"
+#include "deque.h"
+
+// coroutine that starts when an executor runs it; the frame is destroyed when the coroutine finishes
+class task {
+   public:
+    struct promise_type;
+
+    // destroys the frame at the final suspend point and keeps the exception the coroutine finished with
+    struct final_awaiter {
+        bool await_ready() const noexcept;
+        void await_suspend(std::coroutine_handle<promise_type> handle) noexcept;
+        void await_resume() const noexcept;
+    };
+
+    struct promise_type {
+        task get_return_object();
+        std::suspend_always initial_suspend() noexcept;
+        final_awaiter final_suspend() noexcept;
+        void return_void();
+        void unhandled_exception();
+
+        std::exception_ptr exception;
+    };
+
+    // resumes handle; an exception a task finished with during it is rethrown here, after its frame is destroyed
+    static void resume(std::coroutine_handle<> handle);
+
+    explicit task(std::coroutine_handle<promise_type> handle);
+    task(const task&) = delete;
+    task(task&& other) noexcept;
+    task& operator=(const task&) = delete;
+    task& operator=(task&& other) noexcept;
+    ~task();
+
+    // the caller becomes responsible for resuming the coroutine
+    std::coroutine_handle<> release();
+
+   private:
+    // the exception of the task that has just finished on this thread
+    inline static thread_local std::exception_ptr finished_exception_;
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// runs coroutines on the thread that calls run()
+class single_thread_executor {
+   public:
+    single_thread_executor();
+    single_thread_executor(const single_thread_executor&) = delete;
+    single_thread_executor& operator=(const single_thread_executor&) = delete;
+    // destroys the coroutines that are still posted
+    ~single_thread_executor();
+
+    void spawn(task coro);
+    void post(std::coroutine_handle<> handle);
+    void post_batch(std::span<const std::coroutine_handle<>> handles);
+
+    // resumes coroutines until none is ready; returns the number resumed
+    std::size_t run();
+    bool run_one();
+
+   private:
+    block_pool pool_;
+    deque<std::coroutine_handle<>, block_pool_allocator<std::coroutine_handle<>>> ready_;
+};
+
+// runs coroutines on a fixed set of threads; a thread takes up to batch_size ready coroutines per wakeup
+class thread_pool_executor {
+   public:
+    static constexpr std::size_t batch_size = 16;
+
+    explicit thread_pool_executor(std::size_t threads_cnt = std::thread::hardware_concurrency());
+    thread_pool_executor(const thread_pool_executor&) = delete;
+    thread_pool_executor& operator=(const thread_pool_executor&) = delete;
+    // runs the coroutines that are already posted, then joins the threads; an exception is dropped, call join() first
+    ~thread_pool_executor();
+
+    void spawn(task coro);
+    void post(std::coroutine_handle<> handle);
+    void post_batch(std::span<const std::coroutine_handle<>> handles);
+
+    // runs the coroutines that are already posted, joins the threads and rethrows the first exception a task
+    // finished with; nothing can be posted afterwards
+    void join();
+
+   private:
+    void work();
+    void stop();
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    // the first exception a task finished with; the other tasks of its batch still run
+    std::exception_ptr exception_;
+    block_pool pool_;
+    deque<std::coroutine_handle<>, block_pool_allocator<std::coroutine_handle<>>> ready_;
+    std::vector<std::thread> threads_;
+};
+
+#include "executor.inl"
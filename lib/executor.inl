@@ -0,0 +1,200 @@
+#pragma once
+#include "executor.h"
+
+inline task task::promise_type::get_return_object() {
+    return task(std::coroutine_handle<promise_type>::from_promise(*this));
+}
+
+inline std::suspend_always task::promise_type::initial_suspend() noexcept {
+    return {};
+}
+
+inline task::final_awaiter task::promise_type::final_suspend() noexcept {
+    return {};
+}
+
+inline void task::promise_type::return_void() {}
+
+inline void task::promise_type::unhandled_exception() {
+    // rethrowing here would leave the frame suspended at the final point and never destroyed
+    exception = std::current_exception();
+}
+
+inline bool task::final_awaiter::await_ready() const noexcept {
+    return false;
+}
+
+inline void task::final_awaiter::await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+    finished_exception_ = std::move(handle.promise().exception);
+    handle.destroy();
+}
+
+inline void task::final_awaiter::await_resume() const noexcept {}
+
+inline void task::resume(std::coroutine_handle<> handle) {
+    handle.resume();
+    // the exception leaves run() of single_thread_executor or join() of thread_pool_executor
+    if (finished_exception_) {
+        std::rethrow_exception(std::exchange(finished_exception_, nullptr));
+    }
+}
+
+inline task::task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+inline task::task(task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+inline task& task::operator=(task&& other) noexcept {
+    if (this != &other) {
+        if (handle_) {
+            handle_.destroy();
+        }
+        handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+}
+
+inline task::~task() {
+    // a task that was never started
+    if (handle_) {
+        handle_.destroy();
+    }
+}
+
+inline std::coroutine_handle<> task::release() {
+    return std::exchange(handle_, nullptr);
+}
+
+inline single_thread_executor::single_thread_executor()
+    : ready_(block_pool_allocator<std::coroutine_handle<>>(&pool_)) {}
+
+inline single_thread_executor::~single_thread_executor() {
+    for (std::coroutine_handle<> handle : ready_) {
+        handle.destroy();
+    }
+}
+
+inline void single_thread_executor::spawn(task coro) {
+    post(coro.release());
+}
+
+inline void single_thread_executor::post(std::coroutine_handle<> handle) {
+    ready_.push_back(handle);
+}
+
+inline void single_thread_executor::post_batch(std::span<const std::coroutine_handle<>> handles) {
+    ready_.insert(ready_.end(), handles.begin(), handles.end());
+}
+
+inline std::size_t single_thread_executor::run() {
+    std::size_t cnt = 0;
+    while (run_one()) {
+        ++cnt;
+    }
+    return cnt;
+}
+
+inline bool single_thread_executor::run_one() {
+    if (ready_.empty()) {
+        return false;
+    }
+    std::coroutine_handle<> handle = ready_.front();
+    ready_.pop_front();
+    task::resume(handle);
+    return true;
+}
+
+inline thread_pool_executor::thread_pool_executor(std::size_t threads_cnt)
+    : ready_(block_pool_allocator<std::coroutine_handle<>>(&pool_)) {
+    threads_cnt = std::max<std::size_t>(threads_cnt, 1);
+    threads_.reserve(threads_cnt);
+    DEQUE_TRY {
+        for (std::size_t i = 0; i < threads_cnt; ++i) {
+            threads_.emplace_back([this] { work(); });
+        }
+    }
+    DEQUE_CATCH {
+        stop();
+        DEQUE_RETHROW;
+    }
+}
+
+inline thread_pool_executor::~thread_pool_executor() {
+    stop();
+}
+
+inline void thread_pool_executor::join() {
+    stop();
+    if (exception_) {
+        std::rethrow_exception(std::exchange(exception_, nullptr));
+    }
+}
+
+inline void thread_pool_executor::stop() {
+    {
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+inline void thread_pool_executor::spawn(task coro) {
+    post(coro.release());
+}
+
+inline void thread_pool_executor::post(std::coroutine_handle<> handle) {
+    {
+        std::lock_guard lock(mutex_);
+        ready_.push_back(handle);
+    }
+    cv_.notify_one();
+}
+
+inline void thread_pool_executor::post_batch(std::span<const std::coroutine_handle<>> handles) {
+    if (handles.empty()) {
+        return;
+    }
+    {
+        std::lock_guard lock(mutex_);
+        ready_.insert(ready_.end(), handles.begin(), handles.end());
+    }
+    // one thread takes up to batch_size of them
+    if (handles.size() > batch_size) {
+        cv_.notify_all();
+    } else {
+        cv_.notify_one();
+    }
+}
+
+inline void thread_pool_executor::work() {
+    std::coroutine_handle<> batch[batch_size];
+    while (true) {
+        std::size_t cnt;
+        {
+            std::unique_lock lock(mutex_);
+            cv_.wait(lock, [this] { return stop_ || !ready_.empty(); });
+            if (ready_.empty()) {
+                return;
+            }
+            cnt = ready_.drain_front(batch, batch_size);
+            if (!ready_.empty()) {
+                cv_.notify_one();
+            }
+        }
+        for (std::size_t i = 0; i < cnt; ++i) {
+            DEQUE_TRY {
+                task::resume(batch[i]);
+            }
+            DEQUE_CATCH {
+                std::lock_guard lock(mutex_);
+                if (!exception_) {
+                    exception_ = std::current_exception();
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,231 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "deque.h"
+
+// deque whose blocks grow geometrically away from a centre, in the style of a hashed array tree: the blocks on each
+// side hold base, 2 * base, 4 * base, ... elements, so an element is located with a bit scan instead of a division
+// and the map is two fixed arrays of O(log n) entries that are never reallocated. Elements don't move on push and
+// pop; a queue that keeps drifting to one side is moved back to the centre when the elements it has popped outnumber
+// the ones it holds, which keeps the blocks proportional to the size.
+template <typename T, typename Allocator = std::allocator<T>>
+class geometric_deque {
+   public:
+    template <typename Tp>
+    class Iterator;
+
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+
+    using iterator = Iterator<value_type>;
+    using const_iterator = Iterator<const value_type>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    geometric_deque();
+    explicit geometric_deque(const Allocator& alloc);
+    geometric_deque(std::initializer_list<value_type> init, const Allocator& alloc = Allocator());
+
+    template <typename InputIt>
+    geometric_deque(InputIt first, InputIt last, const Allocator& alloc = Allocator());
+
+    geometric_deque(const geometric_deque& other);
+    geometric_deque(geometric_deque&& other) noexcept;
+
+    ~geometric_deque();
+
+    geometric_deque& operator=(const geometric_deque& other);
+    geometric_deque& operator=(geometric_deque&& other) noexcept(
+        std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+        std::allocator_traits<Allocator>::is_always_equal::value);
+
+    allocator_type get_allocator() const;
+
+    reference at(size_type pos);
+    const_reference at(size_type pos) const;
+
+    reference operator[](size_type pos);
+    const_reference operator[](size_type pos) const;
+
+    reference front();
+    const_reference front() const;
+
+    reference back();
+    const_reference back() const;
+
+    iterator begin();
+    const_iterator begin() const;
+    const_iterator cbegin() const noexcept;
+
+    iterator end();
+    const_iterator end() const;
+    const_iterator cend() const noexcept;
+
+    reverse_iterator rbegin();
+    const_reverse_iterator rbegin() const;
+
+    reverse_iterator rend();
+    const_reverse_iterator rend() const;
+
+    [[nodiscard]] bool empty() const;
+    size_type size() const;
+
+    // number of blocks in the map, at most 2 * (log2(size / base) + 2)
+    size_type block_count() const;
+
+    // gives back the blocks kept for reuse
+    void shrink_to_fit();
+
+    void clear();
+
+    void push_back(const value_type& value);
+    void push_back(value_type&& value);
+
+    template <class... Args>
+    reference emplace_back(Args&&... args);
+
+    void pop_back();
+
+    void push_front(const value_type& value);
+    void push_front(value_type&& value);
+
+    template <class... Args>
+    reference emplace_front(Args&&... args);
+
+    void pop_front();
+
+    // references stay valid, iterators don't
+    void swap(geometric_deque& other) noexcept(std::allocator_traits<Allocator>::propagate_on_container_swap::value ||
+                                               std::allocator_traits<Allocator>::is_always_equal::value);
+
+    // the iterator keeps the bounds of the block it is in, so ++ and -- locate an element only between blocks
+    template <typename Tp>
+    class Iterator {
+       public:
+        template <typename U>
+        friend class Iterator;
+
+        using value_type = std::remove_cv_t<Tp>;
+        using reference = Tp&;
+        using pointer = Tp*;
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+
+       private:
+        using container_pointer = const geometric_deque*;
+
+       public:
+        Iterator& operator++();
+        Iterator operator++(int);
+        Iterator& operator--();
+        Iterator operator--(int);
+
+        reference operator*() const;
+        pointer operator->() const;
+        reference operator[](difference_type n) const;
+
+        Iterator& operator+=(difference_type n);
+        Iterator& operator-=(difference_type n);
+
+        Iterator operator+(difference_type n) const;
+        Iterator operator-(difference_type n) const;
+
+        friend Iterator operator+(difference_type n, const Iterator& it) { return it + n; }
+
+        template <typename U>
+        difference_type operator-(const Iterator<U>& it) const;
+
+        bool operator==(const Iterator& other) const;
+        std::strong_ordering operator<=>(const Iterator& other) const;
+
+        Iterator() = default;
+        // pos is counted from the centre of the container
+        Iterator(container_pointer container, difference_type pos);
+
+        template <typename U>
+            requires(std::is_const_v<Tp> && !std::is_const_v<U>)
+        Iterator(const Iterator<U>& other);
+
+       private:
+        void set_pos(difference_type pos);
+        difference_type pos() const;
+
+        container_pointer container_ = nullptr;
+        // position of start_el_, or of the iterator if its block isn't allocated
+        difference_type start_pos_ = 0;
+        pointer curr_el_ = nullptr;
+        pointer start_el_ = nullptr;
+        pointer finish_el_ = nullptr;
+    };
+
+   private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+    // a power of two, so that the level of an element is a shift and a bit scan
+    static constexpr size_type base_ =
+        std::bit_floor(sizeof(T) > deque_buffer_size ? size_type(1) : deque_buffer_size / sizeof(T));
+    static constexpr size_type base_shift_ = std::countr_zero(base_);
+    static constexpr size_type levels_ = std::numeric_limits<size_type>::digits - base_shift_;
+
+    // block of the element at pos and its place there; the slots of a block are in the order of the elements
+    struct location {
+        size_type level;
+        size_type ind;
+        size_type block_size;
+        bool back;
+    };
+
+    // level-th block on each side holds base_ << level elements
+    static size_type level_of(size_type offset);
+    static location locate(difference_type pos);
+    pointer& node(const location& loc);
+    pointer node(const location& loc) const;
+    pointer element(difference_type pos) const;
+
+    // a freed block is kept as the spare of its level, so that a queue moving through the levels
+    // doesn't return large blocks to the system and fault them in again
+    pointer allocate_block(size_type level);
+    void deallocate_block(pointer& block, size_type level);
+    // frees the blocks of levels above 0 and returns to the centre
+    void reset();
+    void deallocate_all();
+    // moves the elements into a new layout that starts (or, if to_front, ends) at the centre
+    void recentre(bool to_front);
+    void move_from(geometric_deque& other);
+
+    Allocator alloc_;
+    // back_[level] holds the elements at positions [0, ...), front_[level] the ones at [..., 0) from the centre
+    std::array<pointer, levels_> back_{};
+    std::array<pointer, levels_> front_{};
+    std::array<pointer, levels_> spare_{};
+    difference_type begin_pos_ = 0;
+    difference_type end_pos_ = 0;
+};
+
+template <class T, class Alloc>
+void swap(geometric_deque<T, Alloc>& lhs, geometric_deque<T, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs)));
+
+template <class T, class Alloc>
+bool operator==(const geometric_deque<T, Alloc>& lhs, const geometric_deque<T, Alloc>& rhs);
+
+template <class T, class Alloc>
+auto operator<=>(const geometric_deque<T, Alloc>& lhs, const geometric_deque<T, Alloc>& rhs);
+
+#include "geometric_deque.inl"
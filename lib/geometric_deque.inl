@@ -0,0 +1,605 @@
+#pragma once
+#include "geometric_deque.h"
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::geometric_deque() : geometric_deque(Allocator()) {}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::geometric_deque(const Allocator& alloc) : alloc_(alloc) {}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::geometric_deque(std::initializer_list<value_type> init, const Allocator& alloc)
+    : geometric_deque(init.begin(), init.end(), alloc) {}
+
+template <typename T, typename Allocator>
+template <typename InputIt>
+geometric_deque<T, Allocator>::geometric_deque(InputIt first, InputIt last, const Allocator& alloc)
+    : alloc_(alloc) {
+    DEQUE_TRY {
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    } DEQUE_CATCH {
+        clear();
+        deallocate_all();
+        DEQUE_RETHROW;
+    }
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::geometric_deque(const geometric_deque& other)
+    : geometric_deque(other.begin(), other.end(), alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::geometric_deque(geometric_deque&& other) noexcept : alloc_(std::move(other.alloc_)) {
+    move_from(other);
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::~geometric_deque() {
+    clear();
+    deallocate_all();
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>& geometric_deque<T, Allocator>::operator=(const geometric_deque& other) {
+    if (this == &other) {
+        return *this;
+    }
+    if (alloc_traits::propagate_on_container_copy_assignment::value && alloc_ != other.alloc_) {
+        // the blocks can't be released by the new allocator
+        clear();
+        deallocate_all();
+    }
+    if (alloc_traits::propagate_on_container_copy_assignment::value) {
+        alloc_ = other.alloc_;
+    }
+    // keeps the old content if copying throws
+    geometric_deque tmp(other.begin(), other.end(), alloc_);
+    clear();
+    deallocate_all();
+    move_from(tmp);
+    return *this;
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>& geometric_deque<T, Allocator>::operator=(geometric_deque&& other) noexcept(
+    std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+    std::allocator_traits<Allocator>::is_always_equal::value) {
+    if (this == &other) {
+        return *this;
+    }
+    clear();
+    if (alloc_traits::propagate_on_container_move_assignment::value || alloc_ == other.alloc_) {
+        deallocate_all();
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+            alloc_ = std::move(other.alloc_);
+        }
+        move_from(other);
+        return *this;
+    }
+    // the blocks of other can't be released by our allocator
+    for (auto& value : other) {
+        emplace_back(std::move(value));
+    }
+    other.clear();
+    return *this;
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::allocator_type geometric_deque<T, Allocator>::get_allocator() const {
+    return alloc_;
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::size_type geometric_deque<T, Allocator>::level_of(size_type offset) {
+    // the blocks of levels below l hold base_ * (2^l - 1) elements
+    return std::bit_width((offset >> base_shift_) + 1) - 1;
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::location geometric_deque<T, Allocator>::locate(difference_type pos) {
+    bool back = pos >= 0;
+    // distance from the centre, the element at -1 is the first one of front_[0]
+    size_type offset = back ? static_cast<size_type>(pos) : static_cast<size_type>(~pos);
+    size_type level = level_of(offset);
+    size_type block_size = base_ << level;
+    size_type ind = offset + base_ - block_size;
+    // the front blocks are filled from their ends, so that the slots follow the order of the elements
+    return location{level, back ? ind : block_size - 1 - ind, block_size, back};
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::pointer& geometric_deque<T, Allocator>::node(const location& loc) {
+    return loc.back ? back_[loc.level] : front_[loc.level];
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::pointer geometric_deque<T, Allocator>::node(const location& loc) const {
+    return loc.back ? back_[loc.level] : front_[loc.level];
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::pointer geometric_deque<T, Allocator>::element(difference_type pos) const {
+    location loc = locate(pos);
+    return node(loc) + loc.ind;
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::reference geometric_deque<T, Allocator>::operator[](size_type pos) {
+    return *element(begin_pos_ + static_cast<difference_type>(pos));
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::const_reference geometric_deque<T, Allocator>::operator[](size_type pos) const {
+    return *element(begin_pos_ + static_cast<difference_type>(pos));
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::reference geometric_deque<T, Allocator>::at(size_type pos) {
+    if (pos >= size()) {
+        deque_throw(std::out_of_range("The size of container is smaller than the numbers in the function argument"));
+    }
+    return (*this)[pos];
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::const_reference geometric_deque<T, Allocator>::at(size_type pos) const {
+    if (pos >= size()) {
+        deque_throw(std::out_of_range("The size of container is smaller than the numbers in the function argument"));
+    }
+    return (*this)[pos];
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::reference geometric_deque<T, Allocator>::front() {
+    return *element(begin_pos_);
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::const_reference geometric_deque<T, Allocator>::front() const {
+    return *element(begin_pos_);
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::reference geometric_deque<T, Allocator>::back() {
+    return *element(end_pos_ - 1);
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::const_reference geometric_deque<T, Allocator>::back() const {
+    return *element(end_pos_ - 1);
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::iterator geometric_deque<T, Allocator>::begin() {
+    return iterator(this, begin_pos_);
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::const_iterator geometric_deque<T, Allocator>::begin() const {
+    return const_iterator(this, begin_pos_);
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::const_iterator geometric_deque<T, Allocator>::cbegin() const noexcept {
+    return const_iterator(this, begin_pos_);
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::iterator geometric_deque<T, Allocator>::end() {
+    return iterator(this, end_pos_);
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::const_iterator geometric_deque<T, Allocator>::end() const {
+    return const_iterator(this, end_pos_);
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::const_iterator geometric_deque<T, Allocator>::cend() const noexcept {
+    return const_iterator(this, end_pos_);
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::reverse_iterator geometric_deque<T, Allocator>::rbegin() {
+    return reverse_iterator(end());
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::const_reverse_iterator geometric_deque<T, Allocator>::rbegin() const {
+    return const_reverse_iterator(end());
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::reverse_iterator geometric_deque<T, Allocator>::rend() {
+    return reverse_iterator(begin());
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::const_reverse_iterator geometric_deque<T, Allocator>::rend() const {
+    return const_reverse_iterator(begin());
+}
+
+template <typename T, typename Allocator>
+bool geometric_deque<T, Allocator>::empty() const {
+    return begin_pos_ == end_pos_;
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::size_type geometric_deque<T, Allocator>::size() const {
+    return static_cast<size_type>(end_pos_ - begin_pos_);
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::size_type geometric_deque<T, Allocator>::block_count() const {
+    auto allocated = [](pointer block) { return block != nullptr; };
+    return std::count_if(back_.begin(), back_.end(), allocated) + std::count_if(front_.begin(), front_.end(), allocated);
+}
+
+template <typename T, typename Allocator>
+void geometric_deque<T, Allocator>::shrink_to_fit() {
+    for (size_type level = 0; level < levels_; ++level) {
+        if (spare_[level] != nullptr) {
+            alloc_traits::deallocate(alloc_, std::exchange(spare_[level], nullptr), base_ << level);
+        }
+    }
+}
+
+template <typename T, typename Allocator>
+void geometric_deque<T, Allocator>::clear() {
+    // destroys the elements block by block
+    for (difference_type pos = begin_pos_; pos < end_pos_;) {
+        location loc = locate(pos);
+        size_type cnt = std::min(static_cast<size_type>(end_pos_ - pos), loc.block_size - loc.ind);
+        pointer block = node(loc);
+        for (size_type i = loc.ind; i < loc.ind + cnt; ++i) {
+            alloc_traits::destroy(alloc_, block + i);
+        }
+        pos += static_cast<difference_type>(cnt);
+    }
+    reset();
+}
+
+template <typename T, typename Allocator>
+geometric_deque<T, Allocator>::pointer geometric_deque<T, Allocator>::allocate_block(size_type level) {
+    if (spare_[level] != nullptr) {
+        return std::exchange(spare_[level], nullptr);
+    }
+    return alloc_traits::allocate(alloc_, base_ << level);
+}
+
+template <typename T, typename Allocator>
+void geometric_deque<T, Allocator>::deallocate_block(pointer& block, size_type level) {
+    if (spare_[level] == nullptr) {
+        spare_[level] = block;
+    } else {
+        alloc_traits::deallocate(alloc_, block, base_ << level);
+    }
+    block = nullptr;
+}
+
+template <typename T, typename Allocator>
+void geometric_deque<T, Allocator>::reset() {
+    // the blocks of level 0 are kept for the next pushes
+    for (size_type level = 1; level < levels_; ++level) {
+        if (back_[level] != nullptr) {
+            deallocate_block(back_[level], level);
+        }
+        if (front_[level] != nullptr) {
+            deallocate_block(front_[level], level);
+        }
+    }
+    begin_pos_ = 0;
+    end_pos_ = 0;
+}
+
+template <typename T, typename Allocator>
+void geometric_deque<T, Allocator>::deallocate_all() {
+    reset();
+    if (back_[0] != nullptr) {
+        deallocate_block(back_[0], 0);
+    }
+    if (front_[0] != nullptr) {
+        deallocate_block(front_[0], 0);
+    }
+    shrink_to_fit();
+}
+
+template <typename T, typename Allocator>
+void geometric_deque<T, Allocator>::move_from(geometric_deque& other) {
+    back_ = std::exchange(other.back_, {});
+    front_ = std::exchange(other.front_, {});
+    spare_ = std::exchange(other.spare_, {});
+    begin_pos_ = std::exchange(other.begin_pos_, 0);
+    end_pos_ = std::exchange(other.end_pos_, 0);
+}
+
+template <typename T, typename Allocator>
+void geometric_deque<T, Allocator>::recentre(bool to_front) {
+    // the elements are copied if moving may throw, so that the deque is unchanged on an exception
+    geometric_deque tmp(alloc_);
+    // the spares are the smaller levels the new layout needs
+    tmp.spare_ = std::exchange(spare_, {});
+    if (to_front) {
+        for (auto it = rbegin(); it != rend(); ++it) {
+            tmp.emplace_front(std::move_if_noexcept(*it));
+        }
+    } else {
+        for (auto& value : *this) {
+            tmp.emplace_back(std::move_if_noexcept(value));
+        }
+    }
+    clear();
+    deallocate_all();
+    move_from(tmp);
+}
+
+template <typename T, typename Allocator>
+void geometric_deque<T, Allocator>::push_back(const value_type& value) {
+    emplace_back(value);
+}
+
+template <typename T, typename Allocator>
+void geometric_deque<T, Allocator>::push_back(value_type&& value) {
+    emplace_back(std::move(value));
+}
+
+template <typename T, typename Allocator>
+template <class... Args>
+geometric_deque<T, Allocator>::reference geometric_deque<T, Allocator>::emplace_back(Args&&... args) {
+    location loc = locate(end_pos_);
+    pointer& block = node(loc);
+    if (block == nullptr) {
+        if (begin_pos_ > 0 && static_cast<size_type>(begin_pos_) > size()) {
+            // a queue that has drifted from the centre would need a block larger than twice its size;
+            // the new element is created first, args may refer to an element that recentre moves
+            value_type value(std::forward<Args>(args)...);
+            recentre(false);
+            return emplace_back(std::move(value));
+        }
+        block = allocate_block(loc.level);
+    }
+    alloc_traits::construct(alloc_, block + loc.ind, std::forward<Args>(args)...);
+    ++end_pos_;
+    return block[loc.ind];
+}
+
+template <typename T, typename Allocator>
+void geometric_deque<T, Allocator>::pop_back() {
+    --end_pos_;
+    location loc = locate(end_pos_);
+    pointer& block = node(loc);
+    alloc_traits::destroy(alloc_, block + loc.ind);
+    if (empty()) {
+        reset();
+    } else if (loc.ind == 0) {
+        deallocate_block(block, loc.level);
+    }
+}
+
+template <typename T, typename Allocator>
+void geometric_deque<T, Allocator>::push_front(const value_type& value) {
+    emplace_front(value);
+}
+
+template <typename T, typename Allocator>
+void geometric_deque<T, Allocator>::push_front(value_type&& value) {
+    emplace_front(std::move(value));
+}
+
+template <typename T, typename Allocator>
+template <class... Args>
+geometric_deque<T, Allocator>::reference geometric_deque<T, Allocator>::emplace_front(Args&&... args) {
+    location loc = locate(begin_pos_ - 1);
+    pointer& block = node(loc);
+    if (block == nullptr) {
+        if (end_pos_ < 0 && static_cast<size_type>(-end_pos_) > size()) {
+            value_type value(std::forward<Args>(args)...);
+            recentre(true);
+            return emplace_front(std::move(value));
+        }
+        block = allocate_block(loc.level);
+    }
+    alloc_traits::construct(alloc_, block + loc.ind, std::forward<Args>(args)...);
+    --begin_pos_;
+    return block[loc.ind];
+}
+
+template <typename T, typename Allocator>
+void geometric_deque<T, Allocator>::pop_front() {
+    location loc = locate(begin_pos_);
+    pointer& block = node(loc);
+    alloc_traits::destroy(alloc_, block + loc.ind);
+    ++begin_pos_;
+    if (empty()) {
+        reset();
+    } else if (loc.ind == loc.block_size - 1) {
+        deallocate_block(block, loc.level);
+    }
+}
+
+template <typename T, typename Allocator>
+void geometric_deque<T, Allocator>::swap(geometric_deque& other) noexcept(
+    std::allocator_traits<Allocator>::propagate_on_container_swap::value ||
+    std::allocator_traits<Allocator>::is_always_equal::value) {
+    if constexpr (alloc_traits::propagate_on_container_swap::value) {
+        std::swap(alloc_, other.alloc_);
+    }
+    std::swap(back_, other.back_);
+    std::swap(front_, other.front_);
+    std::swap(spare_, other.spare_);
+    std::swap(begin_pos_, other.begin_pos_);
+    std::swap(end_pos_, other.end_pos_);
+}
+
+template <typename T, typename Allocator>
+template <typename Tp>
+geometric_deque<T, Allocator>::Iterator<Tp>::Iterator(container_pointer container, difference_type pos)
+    : container_(container) {
+    set_pos(pos);
+}
+
+template <typename T, typename Allocator>
+template <typename Tp>
+template <typename U>
+    requires(std::is_const_v<Tp> && !std::is_const_v<U>)
+geometric_deque<T, Allocator>::Iterator<Tp>::Iterator(const Iterator<U>& other)
+    : container_(other.container_),
+      start_pos_(other.start_pos_),
+      curr_el_(other.curr_el_),
+      start_el_(other.start_el_),
+      finish_el_(other.finish_el_) {}
+
+template <typename T, typename Allocator>
+template <typename Tp>
+void geometric_deque<T, Allocator>::Iterator<Tp>::set_pos(difference_type pos) {
+    location loc = locate(pos);
+    // end() may be at the start of a block that isn't allocated yet
+    start_el_ = container_->node(loc);
+    if (start_el_ == nullptr) {
+        curr_el_ = finish_el_ = nullptr;
+        start_pos_ = pos;
+        return;
+    }
+    curr_el_ = start_el_ + loc.ind;
+    finish_el_ = start_el_ + loc.block_size;
+    start_pos_ = pos - static_cast<difference_type>(loc.ind);
+}
+
+template <typename T, typename Allocator>
+template <typename Tp>
+geometric_deque<T, Allocator>::Iterator<Tp>::difference_type geometric_deque<T, Allocator>::Iterator<Tp>::pos()
+    const {
+    return start_pos_ + (curr_el_ - start_el_);
+}
+
+template <typename T, typename Allocator>
+template <typename Tp>
+geometric_deque<T, Allocator>::Iterator<Tp>& geometric_deque<T, Allocator>::Iterator<Tp>::operator++() {
+    if (++curr_el_ == finish_el_) {
+        set_pos(start_pos_ + (finish_el_ - start_el_));
+    }
+    return *this;
+}
+
+template <typename T, typename Allocator>
+template <typename Tp>
+geometric_deque<T, Allocator>::Iterator<Tp> geometric_deque<T, Allocator>::Iterator<Tp>::operator++(int) {
+    Iterator tmp = *this;
+    ++(*this);
+    return tmp;
+}
+
+template <typename T, typename Allocator>
+template <typename Tp>
+geometric_deque<T, Allocator>::Iterator<Tp>& geometric_deque<T, Allocator>::Iterator<Tp>::operator--() {
+    if (curr_el_ == start_el_) {
+        set_pos(start_pos_ - 1);
+    } else {
+        --curr_el_;
+    }
+    return *this;
+}
+
+template <typename T, typename Allocator>
+template <typename Tp>
+geometric_deque<T, Allocator>::Iterator<Tp> geometric_deque<T, Allocator>::Iterator<Tp>::operator--(int) {
+    Iterator tmp = *this;
+    --(*this);
+    return tmp;
+}
+
+template <typename T, typename Allocator>
+template <typename Tp>
+geometric_deque<T, Allocator>::Iterator<Tp>::reference geometric_deque<T, Allocator>::Iterator<Tp>::operator*()
+    const {
+    return *curr_el_;
+}
+
+template <typename T, typename Allocator>
+template <typename Tp>
+geometric_deque<T, Allocator>::Iterator<Tp>::pointer geometric_deque<T, Allocator>::Iterator<Tp>::operator->()
+    const {
+    return curr_el_;
+}
+
+template <typename T, typename Allocator>
+template <typename Tp>
+geometric_deque<T, Allocator>::Iterator<Tp>::reference geometric_deque<T, Allocator>::Iterator<Tp>::operator[](
+    difference_type n) const {
+    return *(*this + n);
+}
+
+template <typename T, typename Allocator>
+template <typename Tp>
+geometric_deque<T, Allocator>::Iterator<Tp>& geometric_deque<T, Allocator>::Iterator<Tp>::operator+=(
+    difference_type n) {
+    difference_type ind = curr_el_ - start_el_ + n;
+    if (start_el_ != nullptr && ind >= 0 && ind < finish_el_ - start_el_) {
+        curr_el_ += n;
+    } else {
+        set_pos(pos() + n);
+    }
+    return *this;
+}
+
+template <typename T, typename Allocator>
+template <typename Tp>
+geometric_deque<T, Allocator>::Iterator<Tp>& geometric_deque<T, Allocator>::Iterator<Tp>::operator-=(
+    difference_type n) {
+    return *this += -n;
+}
+
+template <typename T, typename Allocator>
+template <typename Tp>
+geometric_deque<T, Allocator>::Iterator<Tp> geometric_deque<T, Allocator>::Iterator<Tp>::operator+(
+    difference_type n) const {
+    Iterator tmp = *this;
+    return tmp += n;
+}
+
+template <typename T, typename Allocator>
+template <typename Tp>
+geometric_deque<T, Allocator>::Iterator<Tp> geometric_deque<T, Allocator>::Iterator<Tp>::operator-(
+    difference_type n) const {
+    Iterator tmp = *this;
+    return tmp -= n;
+}
+
+template <typename T, typename Allocator>
+template <typename Tp>
+template <typename U>
+geometric_deque<T, Allocator>::Iterator<Tp>::difference_type geometric_deque<T, Allocator>::Iterator<Tp>::operator-(
+    const Iterator<U>& it) const {
+    return pos() - it.pos();
+}
+
+template <typename T, typename Allocator>
+template <typename Tp>
+bool geometric_deque<T, Allocator>::Iterator<Tp>::operator==(const Iterator& other) const {
+    // an element has one address; only end() may have none
+    return curr_el_ == other.curr_el_ && (curr_el_ != nullptr || start_pos_ == other.start_pos_);
+}
+
+template <typename T, typename Allocator>
+template <typename Tp>
+std::strong_ordering geometric_deque<T, Allocator>::Iterator<Tp>::operator<=>(const Iterator& other) const {
+    return pos() <=> other.pos();
+}
+
+template <class T, class Alloc>
+void swap(geometric_deque<T, Alloc>& lhs, geometric_deque<T, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+template <class T, class Alloc>
+bool operator==(const geometric_deque<T, Alloc>& lhs, const geometric_deque<T, Alloc>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, class Alloc>
+auto operator<=>(const geometric_deque<T, Alloc>& lhs, const geometric_deque<T, Alloc>& rhs) {
+    return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), synth_three_way);
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+#include "deque.h"
+
+// FIFO window over a deque with O(1) amortized min(), max() and aggregate():
+// - min/max are the fronts of two monotonic deques
+// - aggregate() folds Op over the window with two stacks: the front part keeps suffix aggregates that are rebuilt
+//   when it runs out, the back part keeps one running aggregate
+// Op must be associative, it doesn't need an identity or to be commutative.
+template <typename T, typename Op = std::plus<T>, typename Compare = std::less<T>,
+          typename Allocator = std::allocator<T>>
+class sliding_window {
+    // min/max are tracked only if Compare can order the elements, std::less<T> doesn't check it by itself
+    static constexpr bool ordered_ =
+        std::is_invocable_r_v<bool, Compare&, const T&, const T&> &&
+        (!std::is_same_v<Compare, std::less<T>> || requires(const T& a, const T& b) { a < b; });
+
+   public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using const_iterator = deque<T, Allocator>::const_iterator;
+
+    sliding_window();
+    explicit sliding_window(Op op, Compare comp = Compare(), const Allocator& alloc = Allocator());
+
+    const_reference front() const;
+    const_reference back() const;
+    const_reference operator[](size_type pos) const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    [[nodiscard]] bool empty() const;
+    size_type size() const;
+
+    void clear();
+
+    void push_back(const value_type& value);
+    void push_back(value_type&& value);
+    void pop_front();
+
+    // the window must not be empty
+    const_reference min() const
+        requires(ordered_);
+    const_reference max() const
+        requires(ordered_);
+    value_type aggregate() const;
+
+   private:
+    void push_monotonic(const value_type& value);
+    void flip();
+
+    deque<T, Allocator> values_;
+    // values_[i] for i < front_aggs_.size() is in the front part, front_aggs_[i] is Op over values_[i..front_size)
+    deque<T, Allocator> front_aggs_;
+    std::optional<T> back_agg_;
+    // non-decreasing and non-increasing under comp, equal values are kept so that pop_front can match them
+    deque<T, Allocator> min_;
+    deque<T, Allocator> max_;
+
+    [[no_unique_address]] Op op_;
+    [[no_unique_address]] Compare comp_;
+};
+
+#include "sliding_window.inl"
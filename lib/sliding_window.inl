@@ -0,0 +1,137 @@
+#pragma once
+#include "sliding_window.h"
+
+template <typename T, typename Op, typename Compare, typename Allocator>
+sliding_window<T, Op, Compare, Allocator>::sliding_window() : sliding_window(Op()) {}
+
+template <typename T, typename Op, typename Compare, typename Allocator>
+sliding_window<T, Op, Compare, Allocator>::sliding_window(Op op, Compare comp, const Allocator& alloc)
+    : values_(alloc), front_aggs_(alloc), min_(alloc), max_(alloc), op_(std::move(op)), comp_(std::move(comp)) {}
+
+template <typename T, typename Op, typename Compare, typename Allocator>
+sliding_window<T, Op, Compare, Allocator>::const_reference sliding_window<T, Op, Compare, Allocator>::front() const {
+    return values_.front();
+}
+
+template <typename T, typename Op, typename Compare, typename Allocator>
+sliding_window<T, Op, Compare, Allocator>::const_reference sliding_window<T, Op, Compare, Allocator>::back() const {
+    return values_.back();
+}
+
+template <typename T, typename Op, typename Compare, typename Allocator>
+sliding_window<T, Op, Compare, Allocator>::const_reference sliding_window<T, Op, Compare, Allocator>::operator[](
+    size_type pos) const {
+    return values_[pos];
+}
+
+template <typename T, typename Op, typename Compare, typename Allocator>
+sliding_window<T, Op, Compare, Allocator>::const_iterator sliding_window<T, Op, Compare, Allocator>::begin() const {
+    return values_.begin();
+}
+
+template <typename T, typename Op, typename Compare, typename Allocator>
+sliding_window<T, Op, Compare, Allocator>::const_iterator sliding_window<T, Op, Compare, Allocator>::end() const {
+    return values_.end();
+}
+
+template <typename T, typename Op, typename Compare, typename Allocator>
+bool sliding_window<T, Op, Compare, Allocator>::empty() const {
+    return values_.empty();
+}
+
+template <typename T, typename Op, typename Compare, typename Allocator>
+sliding_window<T, Op, Compare, Allocator>::size_type sliding_window<T, Op, Compare, Allocator>::size() const {
+    return values_.size();
+}
+
+template <typename T, typename Op, typename Compare, typename Allocator>
+void sliding_window<T, Op, Compare, Allocator>::clear() {
+    values_.clear();
+    front_aggs_.clear();
+    back_agg_.reset();
+    min_.clear();
+    max_.clear();
+}
+
+template <typename T, typename Op, typename Compare, typename Allocator>
+void sliding_window<T, Op, Compare, Allocator>::push_monotonic(const value_type& value) {
+    if constexpr (ordered_) {
+        while (!min_.empty() && comp_(value, min_.back())) {
+            min_.pop_back();
+        }
+        min_.push_back(value);
+        while (!max_.empty() && comp_(max_.back(), value)) {
+            max_.pop_back();
+        }
+        max_.push_back(value);
+    }
+}
+
+template <typename T, typename Op, typename Compare, typename Allocator>
+void sliding_window<T, Op, Compare, Allocator>::push_back(const value_type& value) {
+    push_monotonic(value);
+    back_agg_ = back_agg_ ? op_(*back_agg_, value) : value;
+    values_.push_back(value);
+}
+
+template <typename T, typename Op, typename Compare, typename Allocator>
+void sliding_window<T, Op, Compare, Allocator>::push_back(value_type&& value) {
+    push_monotonic(value);
+    back_agg_ = back_agg_ ? op_(*back_agg_, value) : value;
+    values_.push_back(std::move(value));
+}
+
+template <typename T, typename Op, typename Compare, typename Allocator>
+void sliding_window<T, Op, Compare, Allocator>::flip() {
+    // moves the whole back part to the front part, computing its suffix aggregates from the end
+    size_type sz = values_.size();
+    front_aggs_.resize(sz, values_.back());
+    for (size_type i = sz - 1; i-- > 0;) {
+        front_aggs_[i] = op_(values_[i], front_aggs_[i + 1]);
+    }
+    back_agg_.reset();
+}
+
+template <typename T, typename Op, typename Compare, typename Allocator>
+void sliding_window<T, Op, Compare, Allocator>::pop_front() {
+    if (front_aggs_.empty()) {
+        flip();
+    }
+    if constexpr (ordered_) {
+        const T& value = values_.front();
+        // an equal value on the front of a monotonic deque stands for the popped element
+        if (!comp_(min_.front(), value)) {
+            min_.pop_front();
+        }
+        if (!comp_(value, max_.front())) {
+            max_.pop_front();
+        }
+    }
+    front_aggs_.pop_front();
+    values_.pop_front();
+}
+
+template <typename T, typename Op, typename Compare, typename Allocator>
+sliding_window<T, Op, Compare, Allocator>::const_reference sliding_window<T, Op, Compare, Allocator>::min() const
+    requires(ordered_)
+{
+    return min_.front();
+}
+
+template <typename T, typename Op, typename Compare, typename Allocator>
+sliding_window<T, Op, Compare, Allocator>::const_reference sliding_window<T, Op, Compare, Allocator>::max() const
+    requires(ordered_)
+{
+    return max_.front();
+}
+
+template <typename T, typename Op, typename Compare, typename Allocator>
+sliding_window<T, Op, Compare, Allocator>::value_type sliding_window<T, Op, Compare, Allocator>::aggregate() const {
+    if (front_aggs_.empty()) {
+        return *back_agg_;
+    }
+    if (!back_agg_) {
+        return front_aggs_.front();
+    }
+    return op_(front_aggs_.front(), *back_agg_);
+}
@@ -0,0 +1,177 @@
+#pragma once
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+
+#include "deque.h"
+
+// deque that keeps up to N elements in a ring buffer inside the object and moves them into a heap deque
+// only when it outgrows the inline storage
+template <typename T, std::size_t N, typename Allocator = std::allocator<T>>
+class small_deque {
+    static_assert(N > 0, "The inline capacity must be positive.");
+
+   public:
+    template <typename Tp>
+    class Iterator;
+
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = std::allocator_traits<Allocator>::pointer;
+    using const_pointer = std::allocator_traits<Allocator>::const_pointer;
+
+    using iterator = Iterator<value_type>;
+    using const_iterator = Iterator<const value_type>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    small_deque();
+    explicit small_deque(const Allocator& alloc);
+    small_deque(std::initializer_list<value_type> init, const Allocator& alloc = Allocator());
+
+    small_deque(const small_deque& other);
+    small_deque(small_deque&& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    ~small_deque();
+
+    small_deque& operator=(const small_deque& other);
+    small_deque& operator=(small_deque&& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    allocator_type get_allocator() const;
+
+    reference at(size_type pos);
+    const_reference at(size_type pos) const;
+
+    reference operator[](size_type pos);
+    const_reference operator[](size_type pos) const;
+
+    reference front();
+    const_reference front() const;
+
+    reference back();
+    const_reference back() const;
+
+    iterator begin();
+    const_iterator begin() const;
+    const_iterator cbegin() const noexcept;
+
+    iterator end();
+    const_iterator end() const;
+    const_iterator cend() const noexcept;
+
+    reverse_iterator rbegin();
+    const_reverse_iterator rbegin() const;
+
+    reverse_iterator rend();
+    const_reverse_iterator rend() const;
+
+    [[nodiscard]] bool empty() const;
+    size_type size() const;
+
+    // true while the elements are stored inside the object
+    bool is_inline() const;
+    static constexpr size_type inline_capacity();
+
+    void clear();
+
+    void push_back(const value_type& value);
+    void push_back(value_type&& value);
+
+    template <class... Args>
+    reference emplace_back(Args&&... args);
+
+    void pop_back();
+
+    void push_front(const value_type& value);
+    void push_front(value_type&& value);
+
+    template <class... Args>
+    reference emplace_front(Args&&... args);
+
+    void pop_front();
+
+    template <typename Tp>
+    class Iterator {
+       public:
+        template <typename U>
+        friend class Iterator;
+
+        using value_type = std::remove_cv_t<Tp>;
+        using reference = Tp&;
+        using pointer = Tp*;
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+
+       private:
+        using container_pointer = std::conditional_t<std::is_const_v<Tp>, const small_deque*, small_deque*>;
+
+       public:
+        Iterator& operator++();
+        Iterator operator++(int);
+        Iterator& operator--();
+        Iterator operator--(int);
+
+        reference operator*() const;
+        pointer operator->() const;
+        reference operator[](difference_type n) const;
+
+        Iterator& operator+=(difference_type n);
+        Iterator& operator-=(difference_type n);
+
+        Iterator operator+(difference_type n) const;
+        Iterator operator-(difference_type n) const;
+
+        friend Iterator operator+(difference_type n, const Iterator& it) { return it + n; }
+
+        template <typename U>
+        difference_type operator-(const Iterator<U>& it) const;
+
+        bool operator==(const Iterator& other) const;
+        std::strong_ordering operator<=>(const Iterator& other) const;
+
+        Iterator() = default;
+        Iterator(container_pointer container, difference_type ind);
+
+        template <typename U>
+            requires(std::is_const_v<Tp> && !std::is_const_v<U>)
+        Iterator(const Iterator<U>& other);
+
+       private:
+        container_pointer container_ = nullptr;
+        difference_type ind_ = 0;
+    };
+
+   private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+    T* slot(size_type ind);
+    const T* slot(size_type ind) const;
+    // moves the inline elements into the heap deque after the element built from args, which may refer to them;
+    // the new element becomes the back (front) of the heap deque
+    template <bool Back, class... Args>
+    reference spill(Args&&... args);
+    void destroy_inline();
+
+    alignas(T) std::byte inline_storage_[N * sizeof(T)];
+    size_type inline_begin_;
+    size_type inline_size_;
+
+    std::optional<deque<T, Allocator>> heap_;
+    [[no_unique_address]] Allocator alloc_;
+};
+
+template <class T, std::size_t N, class Alloc>
+bool operator==(const small_deque<T, N, Alloc>& lhs, const small_deque<T, N, Alloc>& rhs);
+
+template <class T, std::size_t N, class Alloc>
+auto operator<=>(const small_deque<T, N, Alloc>& lhs, const small_deque<T, N, Alloc>& rhs);
+
+#include "small_deque.inl"
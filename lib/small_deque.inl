@@ -0,0 +1,448 @@
+#pragma once
+#include "small_deque.h"
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::small_deque() : small_deque(Allocator()) {}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::small_deque(const Allocator& alloc)
+    : inline_begin_(0), inline_size_(0), alloc_(alloc) {}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::small_deque(std::initializer_list<value_type> init, const Allocator& alloc)
+    : small_deque(alloc) {
+    for (const auto& value : init) {
+        emplace_back(value);
+    }
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::small_deque(const small_deque& other)
+    : small_deque(alloc_traits::select_on_container_copy_construction(other.alloc_)) {
+    if (other.heap_) {
+        heap_.emplace(*other.heap_, alloc_);
+        return;
+    }
+    for (size_type i = 0; i < other.inline_size_; ++i) {
+        emplace_back(other[i]);
+    }
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::small_deque(small_deque&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    : small_deque(other.alloc_) {
+    if (other.heap_) {
+        heap_.emplace(std::move(*other.heap_));
+        other.heap_.reset();
+        return;
+    }
+    // the inline elements can't be stolen, they are moved one by one
+    for (size_type i = 0; i < other.inline_size_; ++i) {
+        emplace_back(std::move(other[i]));
+    }
+    other.clear();
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::~small_deque() {
+    clear();
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>& small_deque<T, N, Allocator>::operator=(const small_deque& other) {
+    if (this != &other) {
+        small_deque tmp(other);
+        *this = std::move(tmp);
+    }
+    return *this;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>& small_deque<T, N, Allocator>::operator=(small_deque&& other) noexcept(
+    std::is_nothrow_move_constructible_v<T>) {
+    if (this == &other) {
+        return *this;
+    }
+    clear();
+    if (other.heap_) {
+        heap_.emplace(std::move(*other.heap_));
+        other.heap_.reset();
+        return *this;
+    }
+    for (size_type i = 0; i < other.inline_size_; ++i) {
+        emplace_back(std::move(other[i]));
+    }
+    other.clear();
+    return *this;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::allocator_type small_deque<T, N, Allocator>::get_allocator() const {
+    return alloc_;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+T* small_deque<T, N, Allocator>::slot(size_type ind) {
+    return std::launder(reinterpret_cast<T*>(inline_storage_) + ind);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+const T* small_deque<T, N, Allocator>::slot(size_type ind) const {
+    return std::launder(reinterpret_cast<const T*>(inline_storage_) + ind);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <bool Back, class... Args>
+small_deque<T, N, Allocator>::reference small_deque<T, N, Allocator>::spill(Args&&... args) {
+    // the new element is constructed before any inline element is moved from, and nothing changes if an exception
+    // is thrown
+    deque<T, Allocator> heap(alloc_);
+    heap.emplace_back(std::forward<Args>(args)...);
+    if constexpr (Back) {
+        for (size_type i = inline_size_; i-- > 0;) {
+            size_type ind = inline_begin_ + i;
+            heap.emplace_front(std::move_if_noexcept(*slot(ind >= N ? ind - N : ind)));
+        }
+    } else {
+        for (size_type i = 0; i < inline_size_; ++i) {
+            size_type ind = inline_begin_ + i;
+            heap.emplace_back(std::move_if_noexcept(*slot(ind >= N ? ind - N : ind)));
+        }
+    }
+    destroy_inline();
+    heap_.emplace(std::move(heap));
+    return Back ? heap_->back() : heap_->front();
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void small_deque<T, N, Allocator>::destroy_inline() {
+    for (size_type i = 0; i < inline_size_; ++i) {
+        size_type ind = inline_begin_ + i;
+        alloc_traits::destroy(alloc_, slot(ind >= N ? ind - N : ind));
+    }
+    inline_begin_ = 0;
+    inline_size_ = 0;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::reference small_deque<T, N, Allocator>::operator[](size_type pos) {
+    if (heap_) {
+        return (*heap_)[pos];
+    }
+    size_type ind = inline_begin_ + pos;
+    return *slot(ind >= N ? ind - N : ind);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::const_reference small_deque<T, N, Allocator>::operator[](size_type pos) const {
+    if (heap_) {
+        return (*heap_)[pos];
+    }
+    size_type ind = inline_begin_ + pos;
+    return *slot(ind >= N ? ind - N : ind);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::reference small_deque<T, N, Allocator>::at(size_type pos) {
+    if (pos >= size()) {
+        deque_throw(std::out_of_range("The size of container is smaller than the numbers in the function argument"));
+    }
+    return this->operator[](pos);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::const_reference small_deque<T, N, Allocator>::at(size_type pos) const {
+    if (pos >= size()) {
+        deque_throw(std::out_of_range("The size of container is smaller than the numbers in the function argument"));
+    }
+    return this->operator[](pos);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::reference small_deque<T, N, Allocator>::front() {
+    return this->operator[](0);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::const_reference small_deque<T, N, Allocator>::front() const {
+    return this->operator[](0);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::reference small_deque<T, N, Allocator>::back() {
+    return this->operator[](size() - 1);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::const_reference small_deque<T, N, Allocator>::back() const {
+    return this->operator[](size() - 1);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::iterator small_deque<T, N, Allocator>::begin() {
+    return iterator(this, 0);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::const_iterator small_deque<T, N, Allocator>::begin() const {
+    return const_iterator(this, 0);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::const_iterator small_deque<T, N, Allocator>::cbegin() const noexcept {
+    return const_iterator(this, 0);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::iterator small_deque<T, N, Allocator>::end() {
+    return iterator(this, size());
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::const_iterator small_deque<T, N, Allocator>::end() const {
+    return const_iterator(this, size());
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::const_iterator small_deque<T, N, Allocator>::cend() const noexcept {
+    return const_iterator(this, size());
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::reverse_iterator small_deque<T, N, Allocator>::rbegin() {
+    return reverse_iterator(end());
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::const_reverse_iterator small_deque<T, N, Allocator>::rbegin() const {
+    return const_reverse_iterator(end());
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::reverse_iterator small_deque<T, N, Allocator>::rend() {
+    return reverse_iterator(begin());
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::const_reverse_iterator small_deque<T, N, Allocator>::rend() const {
+    return const_reverse_iterator(begin());
+}
+
+template <typename T, std::size_t N, typename Allocator>
+bool small_deque<T, N, Allocator>::empty() const {
+    return size() == 0;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+small_deque<T, N, Allocator>::size_type small_deque<T, N, Allocator>::size() const {
+    return heap_ ? heap_->size() : inline_size_;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+bool small_deque<T, N, Allocator>::is_inline() const {
+    return !heap_;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+constexpr small_deque<T, N, Allocator>::size_type small_deque<T, N, Allocator>::inline_capacity() {
+    return N;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void small_deque<T, N, Allocator>::clear() {
+    // the heap deque is released, so a cleared deque is small again
+    heap_.reset();
+    destroy_inline();
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void small_deque<T, N, Allocator>::push_back(const value_type& value) {
+    emplace_back(value);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void small_deque<T, N, Allocator>::push_back(value_type&& value) {
+    emplace_back(std::move(value));
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <class... Args>
+small_deque<T, N, Allocator>::reference small_deque<T, N, Allocator>::emplace_back(Args&&... args) {
+    if (heap_) {
+        return heap_->emplace_back(std::forward<Args>(args)...);
+    }
+    if (inline_size_ == N) {
+        return spill<true>(std::forward<Args>(args)...);
+    }
+    size_type ind = inline_begin_ + inline_size_;
+    T* el = slot(ind >= N ? ind - N : ind);
+    alloc_traits::construct(alloc_, el, std::forward<Args>(args)...);
+    ++inline_size_;
+    return *el;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void small_deque<T, N, Allocator>::pop_back() {
+    if (heap_) {
+        heap_->pop_back();
+        return;
+    }
+    alloc_traits::destroy(alloc_, &back());
+    --inline_size_;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void small_deque<T, N, Allocator>::push_front(const value_type& value) {
+    emplace_front(value);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void small_deque<T, N, Allocator>::push_front(value_type&& value) {
+    emplace_front(std::move(value));
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <class... Args>
+small_deque<T, N, Allocator>::reference small_deque<T, N, Allocator>::emplace_front(Args&&... args) {
+    if (heap_) {
+        return heap_->emplace_front(std::forward<Args>(args)...);
+    }
+    if (inline_size_ == N) {
+        return spill<false>(std::forward<Args>(args)...);
+    }
+    size_type ind = inline_begin_ == 0 ? N - 1 : inline_begin_ - 1;
+    alloc_traits::construct(alloc_, slot(ind), std::forward<Args>(args)...);
+    inline_begin_ = ind;
+    ++inline_size_;
+    return *slot(ind);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+void small_deque<T, N, Allocator>::pop_front() {
+    if (heap_) {
+        heap_->pop_front();
+        return;
+    }
+    alloc_traits::destroy(alloc_, slot(inline_begin_));
+    inline_begin_ = inline_begin_ == N - 1 ? 0 : inline_begin_ + 1;
+    --inline_size_;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename Tp>
+small_deque<T, N, Allocator>::Iterator<Tp>::Iterator(container_pointer container, difference_type ind)
+    : container_(container), ind_(ind) {}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename Tp>
+template <typename U>
+    requires(std::is_const_v<Tp> && !std::is_const_v<U>)
+small_deque<T, N, Allocator>::Iterator<Tp>::Iterator(const Iterator<U>& other)
+    : container_(other.container_), ind_(other.ind_) {}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename Tp>
+small_deque<T, N, Allocator>::Iterator<Tp>& small_deque<T, N, Allocator>::Iterator<Tp>::operator++() {
+    ++ind_;
+    return *this;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename Tp>
+small_deque<T, N, Allocator>::Iterator<Tp> small_deque<T, N, Allocator>::Iterator<Tp>::operator++(int) {
+    Iterator tmp = *this;
+    ++ind_;
+    return tmp;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename Tp>
+small_deque<T, N, Allocator>::Iterator<Tp>& small_deque<T, N, Allocator>::Iterator<Tp>::operator--() {
+    --ind_;
+    return *this;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename Tp>
+small_deque<T, N, Allocator>::Iterator<Tp> small_deque<T, N, Allocator>::Iterator<Tp>::operator--(int) {
+    Iterator tmp = *this;
+    --ind_;
+    return tmp;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename Tp>
+small_deque<T, N, Allocator>::Iterator<Tp>::reference small_deque<T, N, Allocator>::Iterator<Tp>::operator*() const {
+    return (*container_)[ind_];
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename Tp>
+small_deque<T, N, Allocator>::Iterator<Tp>::pointer small_deque<T, N, Allocator>::Iterator<Tp>::operator->() const {
+    return &(*container_)[ind_];
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename Tp>
+small_deque<T, N, Allocator>::Iterator<Tp>::reference small_deque<T, N, Allocator>::Iterator<Tp>::operator[](
+    difference_type n) const {
+    return (*container_)[ind_ + n];
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename Tp>
+small_deque<T, N, Allocator>::Iterator<Tp>& small_deque<T, N, Allocator>::Iterator<Tp>::operator+=(difference_type n) {
+    ind_ += n;
+    return *this;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename Tp>
+small_deque<T, N, Allocator>::Iterator<Tp>& small_deque<T, N, Allocator>::Iterator<Tp>::operator-=(difference_type n) {
+    ind_ -= n;
+    return *this;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename Tp>
+small_deque<T, N, Allocator>::Iterator<Tp> small_deque<T, N, Allocator>::Iterator<Tp>::operator+(
+    difference_type n) const {
+    return Iterator(container_, ind_ + n);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename Tp>
+small_deque<T, N, Allocator>::Iterator<Tp> small_deque<T, N, Allocator>::Iterator<Tp>::operator-(
+    difference_type n) const {
+    return Iterator(container_, ind_ - n);
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename Tp>
+template <typename U>
+small_deque<T, N, Allocator>::Iterator<Tp>::difference_type small_deque<T, N, Allocator>::Iterator<Tp>::operator-(
+    const Iterator<U>& it) const {
+    return ind_ - it.ind_;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename Tp>
+bool small_deque<T, N, Allocator>::Iterator<Tp>::operator==(const Iterator& other) const {
+    return ind_ == other.ind_;
+}
+
+template <typename T, std::size_t N, typename Allocator>
+template <typename Tp>
+std::strong_ordering small_deque<T, N, Allocator>::Iterator<Tp>::operator<=>(const Iterator& other) const {
+    return ind_ <=> other.ind_;
+}
+
+template <class T, std::size_t N, class Alloc>
+bool operator==(const small_deque<T, N, Alloc>& lhs, const small_deque<T, N, Alloc>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, std::size_t N, class Alloc>
+auto operator<=>(const small_deque<T, N, Alloc>& lhs, const small_deque<T, N, Alloc>& rhs) {
+    return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), synth_three_way);
+}
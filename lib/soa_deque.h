@@ -0,0 +1,189 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "deque.h"
+
+static inline const size_t soa_deque_block_size = 4096;
+
+constexpr std::size_t soa_align_up(std::size_t sz, std::size_t align) {
+    return (sz + align - 1) / align * align;
+}
+
+// deque of records stored as a structure of arrays: the map of blocks is the same as in deque, but every block holds
+// one array per field, so a pass over one field reads only that field's memory
+template <typename... Ts>
+class soa_deque {
+    static_assert(sizeof...(Ts) > 0, "At least one field is required.");
+
+   public:
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    // a row is accessed as a tuple of references to its fields
+    using value_type = std::tuple<Ts...>;
+    using reference = std::tuple<Ts&...>;
+    using const_reference = std::tuple<const Ts&...>;
+
+    template <std::size_t I>
+    using column_type = std::tuple_element_t<I, value_type>;
+
+    template <typename U>
+    class column_view;
+
+    soa_deque();
+
+    soa_deque(const soa_deque& other);
+    soa_deque(soa_deque&& other) noexcept;
+
+    ~soa_deque();
+
+    soa_deque& operator=(const soa_deque& other);
+    soa_deque& operator=(soa_deque&& other) noexcept;
+
+    reference at(size_type pos);
+    const_reference at(size_type pos) const;
+
+    reference operator[](size_type pos);
+    const_reference operator[](size_type pos) const;
+
+    reference front();
+    const_reference front() const;
+
+    reference back();
+    const_reference back() const;
+
+    // the I-th field of the rows in order, as one std::span per block
+    template <std::size_t I>
+    column_view<column_type<I>> column();
+    template <std::size_t I>
+    column_view<const column_type<I>> column() const;
+
+    [[nodiscard]] bool empty() const;
+    size_type size() const;
+
+    void clear();
+
+    // the fields of the new row are constructed from the corresponding arguments
+    template <typename... Us>
+        requires(sizeof...(Us) == sizeof...(Ts))
+    void push_back(Us&&... values);
+
+    template <typename... Us>
+        requires(sizeof...(Us) == sizeof...(Ts))
+    void push_front(Us&&... values);
+
+    void pop_back();
+    void pop_front();
+
+    void swap(soa_deque& other) noexcept;
+
+    // range of std::span<U> over one field of consecutive rows, one span per block
+    template <typename U>
+    class column_view {
+       public:
+        class iterator {
+           public:
+            using value_type = std::span<U>;
+            using difference_type = std::ptrdiff_t;
+            using iterator_category = std::forward_iterator_tag;
+
+            iterator() = default;
+            iterator(std::byte* const* node, size_type ind, size_type left, size_type offset);
+
+            value_type operator*() const;
+            iterator& operator++();
+            iterator operator++(int);
+            bool operator==(const iterator& other) const;
+
+           private:
+            std::byte* const* node_ = nullptr;
+            size_type ind_ = 0;
+            size_type left_ = 0;
+            size_type offset_ = 0;
+        };
+
+        column_view(std::byte* const* node, size_type ind, size_type count, size_type offset);
+
+        iterator begin() const;
+        iterator end() const;
+
+        // number of rows covered by the spans
+        size_type size() const;
+
+       private:
+        std::byte* const* node_;
+        size_type ind_;
+        size_type count_;
+        size_type offset_;
+    };
+
+   private:
+    using block_pointer = std::byte*;
+    using map_pointer = block_pointer*;
+    using map_alloc_traits = std::allocator_traits<std::allocator<block_pointer>>;
+
+    // rows in a block, a power of two so that positions are split with shifts
+    static constexpr size_type buffer_size_ = std::bit_floor(std::max<size_type>(
+        1, soa_deque_block_size / (sizeof(Ts) + ...)));
+    // every column starts on its own cache line
+    static constexpr std::size_t column_align_ = std::max({std::size_t(64), alignof(Ts)...});
+    static constexpr std::array<size_type, sizeof...(Ts)> offsets_ = [] {
+        std::array<size_type, sizeof...(Ts)> offsets{};
+        std::array<size_type, sizeof...(Ts)> sizes{sizeof(Ts)...};
+        size_type offset = 0;
+        for (std::size_t i = 0; i < sizeof...(Ts); ++i) {
+            offsets[i] = offset;
+            offset = soa_align_up(offset + sizes[i] * buffer_size_, column_align_);
+        }
+        return offsets;
+    }();
+    static constexpr size_type block_bytes_ =
+        soa_align_up(offsets_.back() + sizeof(column_type<sizeof...(Ts) - 1>) * buffer_size_, column_align_);
+
+    // map shared by all empty soa_deques, laid out like the one of deque; its slots are never written
+    inline static block_pointer empty_map_[2] = {};
+
+    template <std::size_t I>
+    static column_type<I>* column_data(block_pointer block);
+
+    block_pointer allocate_block();
+    void deallocate_block(map_pointer node);
+    void make_empty();
+    void deallocate_map();
+    void reallocate_map();
+    void locate(size_type pos, map_pointer& node, size_type& ind) const;
+
+    template <std::size_t... Is, typename... Us>
+    void construct_row(std::index_sequence<Is...>, block_pointer block, size_type ind, Us&&... values);
+    template <std::size_t... Is>
+    void destroy_row(std::index_sequence<Is...>, block_pointer block, size_type ind);
+    template <std::size_t... Is>
+    reference make_reference(std::index_sequence<Is...>, block_pointer block, size_type ind) const;
+
+    // borders of capacity
+    map_pointer start_node_;
+    map_pointer finish_node_;
+
+    // borders of storage data
+    map_pointer curr_begin_node_;
+    map_pointer curr_end_node_;
+
+    size_type begin_ind_;
+    size_type end_ind_;
+};
+
+template <typename... Ts>
+void swap(soa_deque<Ts...>& lhs, soa_deque<Ts...>& rhs) noexcept;
+
+#include "soa_deque.inl"
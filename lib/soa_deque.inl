@@ -0,0 +1,388 @@
+#pragma once
+#include "soa_deque.h"
+
+template <typename... Ts>
+soa_deque<Ts...>::soa_deque() {
+    make_empty();
+}
+
+template <typename... Ts>
+soa_deque<Ts...>::soa_deque(const soa_deque& other) : soa_deque() {
+    DEQUE_TRY {
+        for (size_type i = 0; i < other.size(); ++i) {
+            std::apply([this](const Ts&... fields) { push_back(fields...); }, other[i]);
+        }
+    } DEQUE_CATCH {
+        clear();
+        deallocate_map();
+        DEQUE_RETHROW;
+    }
+}
+
+template <typename... Ts>
+soa_deque<Ts...>::soa_deque(soa_deque&& other) noexcept
+    : start_node_(other.start_node_),
+      finish_node_(other.finish_node_),
+      curr_begin_node_(other.curr_begin_node_),
+      curr_end_node_(other.curr_end_node_),
+      begin_ind_(other.begin_ind_),
+      end_ind_(other.end_ind_) {
+    other.make_empty();
+}
+
+template <typename... Ts>
+soa_deque<Ts...>::~soa_deque() {
+    clear();
+    deallocate_map();
+}
+
+template <typename... Ts>
+soa_deque<Ts...>& soa_deque<Ts...>::operator=(const soa_deque& other) {
+    if (this != &other) {
+        soa_deque tmp(other);
+        swap(tmp);
+    }
+    return *this;
+}
+
+template <typename... Ts>
+soa_deque<Ts...>& soa_deque<Ts...>::operator=(soa_deque&& other) noexcept {
+    if (this != &other) {
+        clear();
+        deallocate_map();
+        start_node_ = other.start_node_;
+        finish_node_ = other.finish_node_;
+        curr_begin_node_ = other.curr_begin_node_;
+        curr_end_node_ = other.curr_end_node_;
+        begin_ind_ = other.begin_ind_;
+        end_ind_ = other.end_ind_;
+        other.make_empty();
+    }
+    return *this;
+}
+
+template <typename... Ts>
+template <std::size_t I>
+soa_deque<Ts...>::column_type<I>* soa_deque<Ts...>::column_data(block_pointer block) {
+    return std::launder(reinterpret_cast<column_type<I>*>(block + offsets_[I]));
+}
+
+template <typename... Ts>
+soa_deque<Ts...>::block_pointer soa_deque<Ts...>::allocate_block() {
+    return static_cast<block_pointer>(::operator new(block_bytes_, std::align_val_t(column_align_)));
+}
+
+template <typename... Ts>
+void soa_deque<Ts...>::deallocate_block(map_pointer node) {
+    ::operator delete(*node, block_bytes_, std::align_val_t(column_align_));
+    *node = nullptr;
+}
+
+template <typename... Ts>
+void soa_deque<Ts...>::make_empty() {
+    // the first push at either end reallocates the map before anything is written to it
+    start_node_ = empty_map_ + 1;
+    finish_node_ = empty_map_ + 2;
+    curr_begin_node_ = start_node_;
+    curr_end_node_ = empty_map_;
+    begin_ind_ = 0;
+    end_ind_ = buffer_size_;
+}
+
+template <typename... Ts>
+void soa_deque<Ts...>::deallocate_map() {
+    if (start_node_ == empty_map_ + 1) {
+        return;
+    }
+    std::allocator<block_pointer> alloc;
+    map_alloc_traits::deallocate(alloc, start_node_, finish_node_ - start_node_);
+}
+
+template <typename... Ts>
+void soa_deque<Ts...>::reallocate_map() {
+    // as much free space as the data takes is left on each side, plus one node after curr_end_node_
+    size_type nodes_cnt = curr_end_node_ - curr_begin_node_ + 1;
+    size_type offset_borders = nodes_cnt / 2 + 1;
+    size_type new_cap = nodes_cnt + 2 * offset_borders + 1;
+
+    std::allocator<block_pointer> alloc;
+    map_pointer new_start = map_alloc_traits::allocate(alloc, new_cap);
+    std::fill(new_start, new_start + new_cap, nullptr);
+    map_pointer new_begin = new_start + offset_borders;
+    std::copy(curr_begin_node_, curr_end_node_ + 1, new_begin);
+
+    deallocate_map();
+
+    start_node_ = new_start;
+    finish_node_ = new_start + new_cap;
+    curr_begin_node_ = new_begin;
+    curr_end_node_ = new_begin + nodes_cnt - 1;
+}
+
+template <typename... Ts>
+void soa_deque<Ts...>::locate(size_type pos, map_pointer& node, size_type& ind) const {
+    pos += begin_ind_;
+    node = curr_begin_node_ + pos / buffer_size_;
+    ind = pos % buffer_size_;
+}
+
+template <typename... Ts>
+template <std::size_t... Is, typename... Us>
+void soa_deque<Ts...>::construct_row(std::index_sequence<Is...>, block_pointer block, size_type ind,
+                                     Us&&... values) {
+    // the fields are constructed in order, the constructed ones are destroyed if an exception is thrown
+    std::size_t constructed = 0;
+    DEQUE_TRY {
+        ((std::construct_at(column_data<Is>(block) + ind, std::forward<Us>(values)), ++constructed), ...);
+    } DEQUE_CATCH {
+        ((Is < constructed ? std::destroy_at(column_data<Is>(block) + ind) : void()), ...);
+        DEQUE_RETHROW;
+    }
+}
+
+template <typename... Ts>
+template <std::size_t... Is>
+void soa_deque<Ts...>::destroy_row(std::index_sequence<Is...>, block_pointer block, size_type ind) {
+    (std::destroy_at(column_data<Is>(block) + ind), ...);
+}
+
+template <typename... Ts>
+template <std::size_t... Is>
+soa_deque<Ts...>::reference soa_deque<Ts...>::make_reference(std::index_sequence<Is...>, block_pointer block,
+                                                             size_type ind) const {
+    return reference(column_data<Is>(block)[ind]...);
+}
+
+template <typename... Ts>
+soa_deque<Ts...>::reference soa_deque<Ts...>::operator[](size_type pos) {
+    map_pointer node;
+    size_type ind;
+    locate(pos, node, ind);
+    return make_reference(std::index_sequence_for<Ts...>(), *node, ind);
+}
+
+template <typename... Ts>
+soa_deque<Ts...>::const_reference soa_deque<Ts...>::operator[](size_type pos) const {
+    map_pointer node;
+    size_type ind;
+    locate(pos, node, ind);
+    return make_reference(std::index_sequence_for<Ts...>(), *node, ind);
+}
+
+template <typename... Ts>
+soa_deque<Ts...>::reference soa_deque<Ts...>::at(size_type pos) {
+    if (pos >= size()) {
+        deque_throw(std::out_of_range("The size of container is smaller than the numbers in the function argument"));
+    }
+    return this->operator[](pos);
+}
+
+template <typename... Ts>
+soa_deque<Ts...>::const_reference soa_deque<Ts...>::at(size_type pos) const {
+    if (pos >= size()) {
+        deque_throw(std::out_of_range("The size of container is smaller than the numbers in the function argument"));
+    }
+    return this->operator[](pos);
+}
+
+template <typename... Ts>
+soa_deque<Ts...>::reference soa_deque<Ts...>::front() {
+    return make_reference(std::index_sequence_for<Ts...>(), *curr_begin_node_, begin_ind_);
+}
+
+template <typename... Ts>
+soa_deque<Ts...>::const_reference soa_deque<Ts...>::front() const {
+    return make_reference(std::index_sequence_for<Ts...>(), *curr_begin_node_, begin_ind_);
+}
+
+template <typename... Ts>
+soa_deque<Ts...>::reference soa_deque<Ts...>::back() {
+    return make_reference(std::index_sequence_for<Ts...>(), *curr_end_node_, end_ind_ - 1);
+}
+
+template <typename... Ts>
+soa_deque<Ts...>::const_reference soa_deque<Ts...>::back() const {
+    return make_reference(std::index_sequence_for<Ts...>(), *curr_end_node_, end_ind_ - 1);
+}
+
+template <typename... Ts>
+template <std::size_t I>
+soa_deque<Ts...>::column_view<typename soa_deque<Ts...>::template column_type<I>> soa_deque<Ts...>::column() {
+    return column_view<column_type<I>>(curr_begin_node_, begin_ind_, size(), offsets_[I]);
+}
+
+template <typename... Ts>
+template <std::size_t I>
+soa_deque<Ts...>::column_view<const typename soa_deque<Ts...>::template column_type<I>> soa_deque<Ts...>::column()
+    const {
+    return column_view<const column_type<I>>(curr_begin_node_, begin_ind_, size(), offsets_[I]);
+}
+
+template <typename... Ts>
+bool soa_deque<Ts...>::empty() const {
+    return size() == 0;
+}
+
+template <typename... Ts>
+soa_deque<Ts...>::size_type soa_deque<Ts...>::size() const {
+    return (curr_end_node_ - curr_begin_node_) * buffer_size_ + end_ind_ - begin_ind_;
+}
+
+template <typename... Ts>
+void soa_deque<Ts...>::clear() {
+    for (map_pointer node = curr_begin_node_; node <= curr_end_node_; ++node) {
+        size_type first_ind = node == curr_begin_node_ ? begin_ind_ : 0;
+        size_type last_ind = node == curr_end_node_ ? end_ind_ : buffer_size_;
+        for (size_type ind = first_ind; ind < last_ind; ++ind) {
+            destroy_row(std::index_sequence_for<Ts...>(), *node, ind);
+        }
+        deallocate_block(node);
+    }
+    curr_begin_node_ = start_node_ + (finish_node_ - start_node_) / 2;
+    curr_end_node_ = curr_begin_node_ - 1;
+    begin_ind_ = 0;
+    end_ind_ = buffer_size_;
+}
+
+template <typename... Ts>
+template <typename... Us>
+    requires(sizeof...(Us) == sizeof...(Ts))
+void soa_deque<Ts...>::push_back(Us&&... values) {
+    if (end_ind_ == buffer_size_) {
+        if (finish_node_ - curr_end_node_ <= 2) {
+            reallocate_map();
+        }
+        *(curr_end_node_ + 1) = allocate_block();
+        DEQUE_TRY {
+            construct_row(std::index_sequence_for<Ts...>(), *(curr_end_node_ + 1), 0, std::forward<Us>(values)...);
+        } DEQUE_CATCH {
+            deallocate_block(curr_end_node_ + 1);
+            DEQUE_RETHROW;
+        }
+        ++curr_end_node_;
+        end_ind_ = 1;
+        return;
+    }
+    construct_row(std::index_sequence_for<Ts...>(), *curr_end_node_, end_ind_, std::forward<Us>(values)...);
+    ++end_ind_;
+}
+
+template <typename... Ts>
+template <typename... Us>
+    requires(sizeof...(Us) == sizeof...(Ts))
+void soa_deque<Ts...>::push_front(Us&&... values) {
+    if (begin_ind_ == 0) {
+        if (curr_begin_node_ == start_node_) {
+            reallocate_map();
+        }
+        *(curr_begin_node_ - 1) = allocate_block();
+        DEQUE_TRY {
+            construct_row(std::index_sequence_for<Ts...>(), *(curr_begin_node_ - 1), buffer_size_ - 1,
+                          std::forward<Us>(values)...);
+        } DEQUE_CATCH {
+            deallocate_block(curr_begin_node_ - 1);
+            DEQUE_RETHROW;
+        }
+        --curr_begin_node_;
+        begin_ind_ = buffer_size_ - 1;
+        return;
+    }
+    construct_row(std::index_sequence_for<Ts...>(), *curr_begin_node_, begin_ind_ - 1, std::forward<Us>(values)...);
+    --begin_ind_;
+}
+
+template <typename... Ts>
+void soa_deque<Ts...>::pop_back() {
+    destroy_row(std::index_sequence_for<Ts...>(), *curr_end_node_, --end_ind_);
+    if (end_ind_ == 0) {
+        deallocate_block(curr_end_node_);
+        --curr_end_node_;
+        end_ind_ = buffer_size_;
+    }
+}
+
+template <typename... Ts>
+void soa_deque<Ts...>::pop_front() {
+    destroy_row(std::index_sequence_for<Ts...>(), *curr_begin_node_, begin_ind_);
+    if (++begin_ind_ == buffer_size_) {
+        deallocate_block(curr_begin_node_);
+        ++curr_begin_node_;
+        begin_ind_ = 0;
+    }
+}
+
+template <typename... Ts>
+void soa_deque<Ts...>::swap(soa_deque& other) noexcept {
+    std::swap(start_node_, other.start_node_);
+    std::swap(finish_node_, other.finish_node_);
+    std::swap(curr_begin_node_, other.curr_begin_node_);
+    std::swap(curr_end_node_, other.curr_end_node_);
+    std::swap(begin_ind_, other.begin_ind_);
+    std::swap(end_ind_, other.end_ind_);
+}
+
+template <typename... Ts>
+template <typename U>
+soa_deque<Ts...>::column_view<U>::column_view(std::byte* const* node, size_type ind, size_type count,
+                                               size_type offset)
+    : node_(node), ind_(ind), count_(count), offset_(offset) {}
+
+template <typename... Ts>
+template <typename U>
+soa_deque<Ts...>::column_view<U>::iterator soa_deque<Ts...>::column_view<U>::begin() const {
+    return iterator(node_, ind_, count_, offset_);
+}
+
+template <typename... Ts>
+template <typename U>
+soa_deque<Ts...>::column_view<U>::iterator soa_deque<Ts...>::column_view<U>::end() const {
+    return iterator();
+}
+
+template <typename... Ts>
+template <typename U>
+soa_deque<Ts...>::size_type soa_deque<Ts...>::column_view<U>::size() const {
+    return count_;
+}
+
+template <typename... Ts>
+template <typename U>
+soa_deque<Ts...>::column_view<U>::iterator::iterator(std::byte* const* node, size_type ind, size_type left,
+                                                     size_type offset)
+    : node_(node), ind_(ind), left_(left), offset_(offset) {}
+
+template <typename... Ts>
+template <typename U>
+std::span<U> soa_deque<Ts...>::column_view<U>::iterator::operator*() const {
+    U* column = std::launder(reinterpret_cast<U*>(*node_ + offset_));
+    return std::span<U>(column + ind_, std::min(left_, buffer_size_ - ind_));
+}
+
+template <typename... Ts>
+template <typename U>
+soa_deque<Ts...>::column_view<U>::iterator& soa_deque<Ts...>::column_view<U>::iterator::operator++() {
+    left_ -= std::min(left_, buffer_size_ - ind_);
+    ++node_;
+    ind_ = 0;
+    return *this;
+}
+
+template <typename... Ts>
+template <typename U>
+soa_deque<Ts...>::column_view<U>::iterator soa_deque<Ts...>::column_view<U>::iterator::operator++(int) {
+    iterator tmp = *this;
+    ++*this;
+    return tmp;
+}
+
+template <typename... Ts>
+template <typename U>
+bool soa_deque<Ts...>::column_view<U>::iterator::operator==(const iterator& other) const {
+    // all exhausted iterators are equal to end()
+    return left_ == other.left_ && (left_ == 0 || (node_ == other.node_ && ind_ == other.ind_));
+}
+
+template <typename... Ts>
+void swap(soa_deque<Ts...>& lhs, soa_deque<Ts...>& rhs) noexcept {
+    lhs.swap(rhs);
+}
@@ -0,0 +1,200 @@
+#pragma once
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#include "deque.h"
+
+// what push_back/push_front do when the static_deque is full
+enum class full_policy {
+    reject,     // the new element is dropped
+    overwrite,  // the element at the opposite end is dropped to make room
+    throw_,     // std::length_error is thrown
+};
+
+// deque with a compile-time capacity that never allocates: the elements live in a power-of-two ring buffer
+// inside the object
+template <typename T, std::size_t N, full_policy Policy = full_policy::reject>
+class static_deque {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "The capacity must be a power of two.");
+
+   public:
+    template <typename Tp>
+    class Iterator;
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+
+    using iterator = Iterator<value_type>;
+    using const_iterator = Iterator<const value_type>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static_deque();
+    static_deque(std::initializer_list<value_type> init);
+
+    static_deque(const static_deque& other);
+    static_deque(static_deque&& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    ~static_deque();
+
+    static_deque& operator=(const static_deque& other);
+    static_deque& operator=(static_deque&& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    reference at(size_type pos);
+    const_reference at(size_type pos) const;
+
+    reference operator[](size_type pos);
+    const_reference operator[](size_type pos) const;
+
+    reference front();
+    const_reference front() const;
+
+    reference back();
+    const_reference back() const;
+
+    iterator begin();
+    const_iterator begin() const;
+    const_iterator cbegin() const noexcept;
+
+    iterator end();
+    const_iterator end() const;
+    const_iterator cend() const noexcept;
+
+    reverse_iterator rbegin();
+    const_reverse_iterator rbegin() const;
+
+    reverse_iterator rend();
+    const_reverse_iterator rend() const;
+
+    [[nodiscard]] bool empty() const;
+    bool full() const;
+    size_type size() const;
+    static constexpr size_type max_size();
+    static constexpr size_type capacity();
+
+    void clear();
+
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+
+    // when a full static_deque rejects the new element, emplace_back returns back() and emplace_front returns front()
+    void push_back(const value_type& value);
+    void push_back(value_type&& value);
+
+    template <class... Args>
+    reference emplace_back(Args&&... args);
+
+    void pop_back();
+
+    void push_front(const value_type& value);
+    void push_front(value_type&& value);
+
+    template <class... Args>
+    reference emplace_front(Args&&... args);
+
+    void pop_front();
+
+    // add the element only if there is room, whatever the policy: return false (nullptr) when full
+    bool try_push_back(const value_type& value);
+    bool try_push_back(value_type&& value);
+
+    template <class... Args>
+    pointer try_emplace_back(Args&&... args);
+
+    bool try_push_front(const value_type& value);
+    bool try_push_front(value_type&& value);
+
+    template <class... Args>
+    pointer try_emplace_front(Args&&... args);
+
+    void swap(static_deque& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    template <typename Tp>
+    class Iterator {
+       public:
+        template <typename U>
+        friend class Iterator;
+
+        using value_type = std::remove_cv_t<Tp>;
+        using reference = Tp&;
+        using pointer = Tp*;
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+
+       private:
+        using container_pointer = std::conditional_t<std::is_const_v<Tp>, const static_deque*, static_deque*>;
+
+       public:
+        Iterator& operator++();
+        Iterator operator++(int);
+        Iterator& operator--();
+        Iterator operator--(int);
+
+        reference operator*() const;
+        pointer operator->() const;
+        reference operator[](difference_type n) const;
+
+        Iterator& operator+=(difference_type n);
+        Iterator& operator-=(difference_type n);
+
+        Iterator operator+(difference_type n) const;
+        Iterator operator-(difference_type n) const;
+
+        friend Iterator operator+(difference_type n, const Iterator& it) { return it + n; }
+
+        template <typename U>
+        difference_type operator-(const Iterator<U>& it) const;
+
+        bool operator==(const Iterator& other) const;
+        std::strong_ordering operator<=>(const Iterator& other) const;
+
+        Iterator() = default;
+        Iterator(container_pointer container, difference_type ind);
+
+        template <typename U>
+            requires(std::is_const_v<Tp> && !std::is_const_v<U>)
+        Iterator(const Iterator<U>& other);
+
+       private:
+        container_pointer container_ = nullptr;
+        difference_type ind_ = 0;
+    };
+
+   private:
+    static constexpr size_type mask_ = N - 1;
+
+    T* slot(size_type ind);
+    const T* slot(size_type ind) const;
+    // returns true if one more element fits, throws under full_policy::throw_
+    bool has_room() const;
+
+    alignas(T) std::byte storage_[N * sizeof(T)];
+    size_type head_;
+    size_type size_;
+};
+
+template <class T, std::size_t N, full_policy P>
+void swap(static_deque<T, N, P>& lhs, static_deque<T, N, P>& rhs) noexcept(noexcept(lhs.swap(rhs)));
+
+template <class T, std::size_t N, full_policy P>
+bool operator==(const static_deque<T, N, P>& lhs, const static_deque<T, N, P>& rhs);
+
+template <class T, std::size_t N, full_policy P>
+auto operator<=>(const static_deque<T, N, P>& lhs, const static_deque<T, N, P>& rhs);
+
+template <class T, std::size_t N, full_policy P, class U = T>
+typename static_deque<T, N, P>::size_type erase(static_deque<T, N, P>& c, const U& value);
+
+template <class T, std::size_t N, full_policy P, class Pred>
+typename static_deque<T, N, P>::size_type erase_if(static_deque<T, N, P>& c, Pred pred);
+
+#include "static_deque.inl"
@@ -0,0 +1,495 @@
+#pragma once
+#include "static_deque.h"
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::static_deque() : head_(0), size_(0) {}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::static_deque(std::initializer_list<value_type> init) : static_deque() {
+    for (const auto& value : init) {
+        push_back(value);
+    }
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::static_deque(const static_deque& other) : static_deque() {
+    for (size_type i = 0; i < other.size_; ++i) {
+        emplace_back(other[i]);
+    }
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::static_deque(static_deque&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    : static_deque() {
+    for (size_type i = 0; i < other.size_; ++i) {
+        emplace_back(std::move(other[i]));
+    }
+    other.clear();
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::~static_deque() {
+    clear();
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>& static_deque<T, N, Policy>::operator=(const static_deque& other) {
+    if (this != &other) {
+        static_deque tmp(other);
+        *this = std::move(tmp);
+    }
+    return *this;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>& static_deque<T, N, Policy>::operator=(static_deque&& other) noexcept(
+    std::is_nothrow_move_constructible_v<T>) {
+    if (this == &other) {
+        return *this;
+    }
+    clear();
+    for (size_type i = 0; i < other.size_; ++i) {
+        emplace_back(std::move(other[i]));
+    }
+    other.clear();
+    return *this;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+T* static_deque<T, N, Policy>::slot(size_type ind) {
+    return std::launder(reinterpret_cast<T*>(storage_) + (ind & mask_));
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+const T* static_deque<T, N, Policy>::slot(size_type ind) const {
+    return std::launder(reinterpret_cast<const T*>(storage_) + (ind & mask_));
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::reference static_deque<T, N, Policy>::operator[](size_type pos) {
+    return *slot(head_ + pos);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::const_reference static_deque<T, N, Policy>::operator[](size_type pos) const {
+    return *slot(head_ + pos);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::reference static_deque<T, N, Policy>::at(size_type pos) {
+    if (pos >= size_) {
+        deque_throw(std::out_of_range("The size of container is smaller than the numbers in the function argument"));
+    }
+    return *slot(head_ + pos);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::const_reference static_deque<T, N, Policy>::at(size_type pos) const {
+    if (pos >= size_) {
+        deque_throw(std::out_of_range("The size of container is smaller than the numbers in the function argument"));
+    }
+    return *slot(head_ + pos);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::reference static_deque<T, N, Policy>::front() {
+    return *slot(head_);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::const_reference static_deque<T, N, Policy>::front() const {
+    return *slot(head_);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::reference static_deque<T, N, Policy>::back() {
+    return *slot(head_ + size_ - 1);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::const_reference static_deque<T, N, Policy>::back() const {
+    return *slot(head_ + size_ - 1);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::iterator static_deque<T, N, Policy>::begin() {
+    return iterator(this, 0);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::const_iterator static_deque<T, N, Policy>::begin() const {
+    return const_iterator(this, 0);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::const_iterator static_deque<T, N, Policy>::cbegin() const noexcept {
+    return const_iterator(this, 0);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::iterator static_deque<T, N, Policy>::end() {
+    return iterator(this, size_);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::const_iterator static_deque<T, N, Policy>::end() const {
+    return const_iterator(this, size_);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::const_iterator static_deque<T, N, Policy>::cend() const noexcept {
+    return const_iterator(this, size_);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::reverse_iterator static_deque<T, N, Policy>::rbegin() {
+    return reverse_iterator(end());
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::const_reverse_iterator static_deque<T, N, Policy>::rbegin() const {
+    return const_reverse_iterator(end());
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::reverse_iterator static_deque<T, N, Policy>::rend() {
+    return reverse_iterator(begin());
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::const_reverse_iterator static_deque<T, N, Policy>::rend() const {
+    return const_reverse_iterator(begin());
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+bool static_deque<T, N, Policy>::empty() const {
+    return size_ == 0;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+bool static_deque<T, N, Policy>::full() const {
+    return size_ == N;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::size_type static_deque<T, N, Policy>::size() const {
+    return size_;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+constexpr static_deque<T, N, Policy>::size_type static_deque<T, N, Policy>::max_size() {
+    return N;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+constexpr static_deque<T, N, Policy>::size_type static_deque<T, N, Policy>::capacity() {
+    return N;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+void static_deque<T, N, Policy>::clear() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        for (size_type i = 0; i < size_; ++i) {
+            std::destroy_at(slot(head_ + i));
+        }
+    }
+    head_ = 0;
+    size_ = 0;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::iterator static_deque<T, N, Policy>::erase(const_iterator pos) {
+    return erase(pos, pos + 1);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+static_deque<T, N, Policy>::iterator static_deque<T, N, Policy>::erase(const_iterator first, const_iterator last) {
+    // shifts the shorter side over the erased range
+    difference_type first_ind = first - cbegin();
+    difference_type last_ind = last - cbegin();
+    difference_type cnt = last_ind - first_ind;
+    if (cnt == 0) {
+        return begin() + first_ind;
+    }
+    if (first_ind < static_cast<difference_type>(size_) - last_ind) {
+        std::move_backward(begin(), begin() + first_ind, begin() + last_ind);
+        for (difference_type i = 0; i < cnt; ++i) {
+            pop_front();
+        }
+    } else {
+        std::move(begin() + last_ind, end(), begin() + first_ind);
+        for (difference_type i = 0; i < cnt; ++i) {
+            pop_back();
+        }
+    }
+    return begin() + first_ind;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+bool static_deque<T, N, Policy>::has_room() const {
+    if (size_ < N) {
+        return true;
+    }
+    if constexpr (Policy == full_policy::throw_) {
+        deque_throw(std::length_error("The static_deque is full"));
+    }
+    return false;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+void static_deque<T, N, Policy>::push_back(const value_type& value) {
+    emplace_back(value);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+void static_deque<T, N, Policy>::push_back(value_type&& value) {
+    emplace_back(std::move(value));
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <class... Args>
+static_deque<T, N, Policy>::reference static_deque<T, N, Policy>::emplace_back(Args&&... args) {
+    if (!has_room()) {
+        if constexpr (Policy == full_policy::overwrite) {
+            // the oldest element occupies the slot after back(), it is assigned over and becomes the new back
+            T& el = *slot(head_);
+            el = T(std::forward<Args>(args)...);
+            head_ = (head_ + 1) & mask_;
+            return el;
+        } else {
+            return back();
+        }
+    }
+    return *try_emplace_back(std::forward<Args>(args)...);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+void static_deque<T, N, Policy>::pop_back() {
+    --size_;
+    std::destroy_at(slot(head_ + size_));
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+void static_deque<T, N, Policy>::push_front(const value_type& value) {
+    emplace_front(value);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+void static_deque<T, N, Policy>::push_front(value_type&& value) {
+    emplace_front(std::move(value));
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <class... Args>
+static_deque<T, N, Policy>::reference static_deque<T, N, Policy>::emplace_front(Args&&... args) {
+    if (!has_room()) {
+        if constexpr (Policy == full_policy::overwrite) {
+            // the newest element occupies the slot before front(), it is assigned over and becomes the new front
+            head_ = (head_ - 1) & mask_;
+            T& el = *slot(head_);
+            el = T(std::forward<Args>(args)...);
+            return el;
+        } else {
+            return front();
+        }
+    }
+    return *try_emplace_front(std::forward<Args>(args)...);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+void static_deque<T, N, Policy>::pop_front() {
+    std::destroy_at(slot(head_));
+    head_ = (head_ + 1) & mask_;
+    --size_;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+bool static_deque<T, N, Policy>::try_push_back(const value_type& value) {
+    return try_emplace_back(value) != nullptr;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+bool static_deque<T, N, Policy>::try_push_back(value_type&& value) {
+    return try_emplace_back(std::move(value)) != nullptr;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <class... Args>
+static_deque<T, N, Policy>::pointer static_deque<T, N, Policy>::try_emplace_back(Args&&... args) {
+    if (size_ == N) {
+        return nullptr;
+    }
+    T* el = std::construct_at(slot(head_ + size_), std::forward<Args>(args)...);
+    ++size_;
+    return el;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+bool static_deque<T, N, Policy>::try_push_front(const value_type& value) {
+    return try_emplace_front(value) != nullptr;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+bool static_deque<T, N, Policy>::try_push_front(value_type&& value) {
+    return try_emplace_front(std::move(value)) != nullptr;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <class... Args>
+static_deque<T, N, Policy>::pointer static_deque<T, N, Policy>::try_emplace_front(Args&&... args) {
+    if (size_ == N) {
+        return nullptr;
+    }
+    T* el = std::construct_at(slot(head_ - 1), std::forward<Args>(args)...);
+    head_ = (head_ - 1) & mask_;
+    ++size_;
+    return el;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+void static_deque<T, N, Policy>::swap(static_deque& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    // the elements live inside the objects, so they are moved instead of the storage
+    static_deque tmp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(tmp);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <typename Tp>
+static_deque<T, N, Policy>::Iterator<Tp>::Iterator(container_pointer container, difference_type ind)
+    : container_(container), ind_(ind) {}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <typename Tp>
+template <typename U>
+    requires(std::is_const_v<Tp> && !std::is_const_v<U>)
+static_deque<T, N, Policy>::Iterator<Tp>::Iterator(const Iterator<U>& other)
+    : container_(other.container_), ind_(other.ind_) {}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <typename Tp>
+static_deque<T, N, Policy>::Iterator<Tp>& static_deque<T, N, Policy>::Iterator<Tp>::operator++() {
+    ++ind_;
+    return *this;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <typename Tp>
+static_deque<T, N, Policy>::Iterator<Tp> static_deque<T, N, Policy>::Iterator<Tp>::operator++(int) {
+    Iterator tmp = *this;
+    ++ind_;
+    return tmp;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <typename Tp>
+static_deque<T, N, Policy>::Iterator<Tp>& static_deque<T, N, Policy>::Iterator<Tp>::operator--() {
+    --ind_;
+    return *this;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <typename Tp>
+static_deque<T, N, Policy>::Iterator<Tp> static_deque<T, N, Policy>::Iterator<Tp>::operator--(int) {
+    Iterator tmp = *this;
+    --ind_;
+    return tmp;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <typename Tp>
+static_deque<T, N, Policy>::Iterator<Tp>::reference static_deque<T, N, Policy>::Iterator<Tp>::operator*() const {
+    return (*container_)[ind_];
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <typename Tp>
+static_deque<T, N, Policy>::Iterator<Tp>::pointer static_deque<T, N, Policy>::Iterator<Tp>::operator->() const {
+    return &(*container_)[ind_];
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <typename Tp>
+static_deque<T, N, Policy>::Iterator<Tp>::reference static_deque<T, N, Policy>::Iterator<Tp>::operator[](
+    difference_type n) const {
+    return (*container_)[ind_ + n];
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <typename Tp>
+static_deque<T, N, Policy>::Iterator<Tp>& static_deque<T, N, Policy>::Iterator<Tp>::operator+=(difference_type n) {
+    ind_ += n;
+    return *this;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <typename Tp>
+static_deque<T, N, Policy>::Iterator<Tp>& static_deque<T, N, Policy>::Iterator<Tp>::operator-=(difference_type n) {
+    ind_ -= n;
+    return *this;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <typename Tp>
+static_deque<T, N, Policy>::Iterator<Tp> static_deque<T, N, Policy>::Iterator<Tp>::operator+(
+    difference_type n) const {
+    return Iterator(container_, ind_ + n);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <typename Tp>
+static_deque<T, N, Policy>::Iterator<Tp> static_deque<T, N, Policy>::Iterator<Tp>::operator-(
+    difference_type n) const {
+    return Iterator(container_, ind_ - n);
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <typename Tp>
+template <typename U>
+static_deque<T, N, Policy>::Iterator<Tp>::difference_type static_deque<T, N, Policy>::Iterator<Tp>::operator-(
+    const Iterator<U>& it) const {
+    return ind_ - it.ind_;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <typename Tp>
+bool static_deque<T, N, Policy>::Iterator<Tp>::operator==(const Iterator& other) const {
+    return ind_ == other.ind_;
+}
+
+template <typename T, std::size_t N, full_policy Policy>
+template <typename Tp>
+std::strong_ordering static_deque<T, N, Policy>::Iterator<Tp>::operator<=>(const Iterator& other) const {
+    return ind_ <=> other.ind_;
+}
+
+template <class T, std::size_t N, full_policy P>
+void swap(static_deque<T, N, P>& lhs, static_deque<T, N, P>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+template <class T, std::size_t N, full_policy P>
+bool operator==(const static_deque<T, N, P>& lhs, const static_deque<T, N, P>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <class T, std::size_t N, full_policy P>
+auto operator<=>(const static_deque<T, N, P>& lhs, const static_deque<T, N, P>& rhs) {
+    return std::lexicographical_compare_three_way(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), synth_three_way);
+}
+
+template <class T, std::size_t N, full_policy P, class U>
+typename static_deque<T, N, P>::size_type erase(static_deque<T, N, P>& c, const U& value) {
+    auto it = std::remove(c.begin(), c.end(), value);
+    typename static_deque<T, N, P>::size_type r = c.end() - it;
+    c.erase(it, c.end());
+    return r;
+}
+
+template <class T, std::size_t N, full_policy P, class Pred>
+typename static_deque<T, N, P>::size_type erase_if(static_deque<T, N, P>& c, Pred pred) {
+    auto it = std::remove_if(c.begin(), c.end(), pred);
+    typename static_deque<T, N, P>::size_type r = c.end() - it;
+    c.erase(it, c.end());
+    return r;
+}